@@ -0,0 +1,86 @@
+#
+#
+# This file is part of yacas.
+# Yacas is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesset General Public License as
+# published by the Free Software Foundation, either version 2.1
+# of the License, or (at your option) any later version.
+#
+# Yacas is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with yacas.  If not, see <http://www.gnu.org/licenses/>.
+#
+#
+
+# yacas_add_benchmark (target)
+#
+# Hooks the Google Benchmark executable target into
+#
+#   bench           runs all the benchmarks
+#   bench_baseline  runs them and stores the results in
+#                   YACAS_BENCHMARK_BASELINE_DIR
+#   bench_compare   runs them and reports the cases which got slower than
+#                   the stored baseline by more than
+#                   YACAS_BENCHMARK_THRESHOLD percent, failing if there are
+#                   any
+#
+# The benchmarks are run one after another, so that they don't disturb
+# each other's timings in a parallel build.
+
+find_package (Python3 REQUIRED COMPONENTS Interpreter)
+
+set (YACAS_BENCHMARK_BASELINE_DIR "${CMAKE_BINARY_DIR}/benchmark_baseline" CACHE PATH "directory holding the benchmark results bench_compare compares with")
+set (YACAS_BENCHMARK_THRESHOLD 10 CACHE STRING "slowdown in percent bench_compare reports as a regression")
+set (YACAS_BENCHMARK_ARGS --benchmark_min_time=0.1 CACHE STRING "arguments passed to the benchmarks")
+
+set (_yacas_benchmark_compare "${CMAKE_SOURCE_DIR}/utils/benchmark_compare.py")
+
+function (yacas_add_benchmark target)
+    if (NOT TARGET bench)
+        add_custom_target (bench)
+        add_custom_target (bench_baseline)
+        add_custom_target (bench_compare
+            COMMAND ${Python3_EXECUTABLE} ${_yacas_benchmark_compare}
+                    --threshold ${YACAS_BENCHMARK_THRESHOLD}
+                    "${YACAS_BENCHMARK_BASELINE_DIR}"
+                    $<TARGET_PROPERTY:bench_compare,YACAS_BENCHMARK_RESULTS>
+            COMMAND_EXPAND_LISTS
+            USES_TERMINAL)
+    endif ()
+
+    get_property (previous GLOBAL PROPERTY YACAS_BENCHMARK_LAST)
+
+    set (baseline "${YACAS_BENCHMARK_BASELINE_DIR}/${target}.json")
+    set (current "${CMAKE_CURRENT_BINARY_DIR}/${target}.json")
+    set (json --benchmark_out_format=json)
+
+    add_custom_target (${target}_run
+        COMMAND ${target} ${YACAS_BENCHMARK_ARGS}
+        USES_TERMINAL)
+
+    add_custom_target (${target}_baseline
+        COMMAND ${CMAKE_COMMAND} -E make_directory "${YACAS_BENCHMARK_BASELINE_DIR}"
+        COMMAND ${target} ${YACAS_BENCHMARK_ARGS} --benchmark_out=${baseline} ${json}
+        USES_TERMINAL)
+
+    add_custom_target (${target}_current
+        COMMAND ${target} ${YACAS_BENCHMARK_ARGS} --benchmark_out=${current} ${json}
+        USES_TERMINAL)
+
+    foreach (t run baseline current)
+        if (previous)
+            add_dependencies (${target}_${t} ${previous}_${t})
+        endif ()
+    endforeach ()
+
+    add_dependencies (bench ${target}_run)
+    add_dependencies (bench_baseline ${target}_baseline)
+    add_dependencies (bench_compare ${target}_current)
+    set_property (TARGET bench_compare APPEND PROPERTY YACAS_BENCHMARK_RESULTS ${current})
+
+    set_property (GLOBAL PROPERTY YACAS_BENCHMARK_LAST ${target})
+endfunction ()
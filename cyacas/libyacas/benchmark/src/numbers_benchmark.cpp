@@ -0,0 +1,193 @@
+/*
+ *
+ * This file is part of yacas.
+ * Yacas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesset General Public License as
+ * published by the Free Software Foundation, either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * Yacas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with yacas.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "yacas/numbers.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+std::mt19937_64 rng;
+
+// a random float literal with the given number of significant digits
+static std::string random_float(std::size_t digits)
+{
+    std::uniform_int_distribution<int> d(0, 9);
+
+    std::string s(digits + 1, '0');
+    s[0] = '1' + d(rng) % 9;
+    s[1] = '.';
+    for (std::size_t i = 2; i <= digits; ++i)
+        s[i] = '0' + d(rng);
+
+    return s;
+}
+
+// a random integer literal with the given number of digits
+static std::string random_int(std::size_t digits)
+{
+    std::string s = random_float(digits + 1);
+    s.erase(1, 1);
+    return s;
+}
+
+// Precisions are given in decimal digits, as set by Builtin'Precision'Set,
+// and converted to bits where BigNumber expects them.
+
+static void BM_BigNumber_construct(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        const std::string s = random_float(state.range(0));
+        state.ResumeTiming();
+        BigNumber x(s, state.range(0));
+    }
+    state.SetComplexityN(state.range());
+}
+
+static void BM_BigNumber_construct_int(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        const std::string s = random_int(state.range(0));
+        state.ResumeTiming();
+        BigNumber x(s, 10);
+    }
+    state.SetComplexityN(state.range());
+}
+
+static void BM_BigNumber_Multiply(benchmark::State& state)
+{
+    const int digits = state.range(0);
+    const int bits = digits_to_bits(digits, 10);
+
+    for (auto _: state) {
+        state.PauseTiming();
+        const BigNumber x(random_float(digits), digits);
+        const BigNumber y(random_float(digits), digits);
+        BigNumber z("0", digits);
+        state.ResumeTiming();
+        z.Multiply(x, y, bits);
+    }
+    state.SetComplexityN(state.range());
+}
+
+static void BM_BigNumber_Divide(benchmark::State& state)
+{
+    const int digits = state.range(0);
+    const int bits = digits_to_bits(digits, 10);
+
+    for (auto _: state) {
+        state.PauseTiming();
+        const BigNumber x(random_float(digits), digits);
+        const BigNumber y(random_float(digits), digits);
+        BigNumber z("0", digits);
+        state.ResumeTiming();
+        z.Divide(x, y, bits);
+    }
+    state.SetComplexityN(state.range());
+}
+
+static void BM_BigNumber_Add(benchmark::State& state)
+{
+    const int digits = state.range(0);
+    const int bits = digits_to_bits(digits, 10);
+
+    for (auto _: state) {
+        state.PauseTiming();
+        const BigNumber x(random_float(digits), digits);
+        const BigNumber y(random_float(digits), digits);
+        BigNumber z("0", digits);
+        state.ResumeTiming();
+        z.Add(x, y, bits);
+    }
+    state.SetComplexityN(state.range());
+}
+
+static void BM_BigNumber_Exp(benchmark::State& state)
+{
+    const int digits = state.range(0);
+    const int bits = digits_to_bits(digits, 10);
+
+    for (auto _: state) {
+        state.PauseTiming();
+        const BigNumber x(random_float(digits), digits);
+        BigNumber z("0", digits);
+        state.ResumeTiming();
+        z.Exp(x, bits);
+    }
+    state.SetComplexityN(state.range());
+}
+
+static void BM_BigNumber_Sin(benchmark::State& state)
+{
+    const int digits = state.range(0);
+    const int bits = digits_to_bits(digits, 10);
+
+    for (auto _: state) {
+        state.PauseTiming();
+        const BigNumber x(random_float(digits), digits);
+        BigNumber z("0", digits);
+        state.ResumeTiming();
+        z.Sin(x, bits);
+    }
+    state.SetComplexityN(state.range());
+}
+
+static void BM_BigNumber_Sqrt(benchmark::State& state)
+{
+    const int digits = state.range(0);
+    const int bits = digits_to_bits(digits, 10);
+
+    for (auto _: state) {
+        state.PauseTiming();
+        const BigNumber x(random_float(digits), digits);
+        BigNumber z("0", digits);
+        state.ResumeTiming();
+        z.Sqrt(x, bits);
+    }
+    state.SetComplexityN(state.range());
+}
+
+static void BM_BigNumber_ToString(benchmark::State& state)
+{
+    const int digits = state.range(0);
+
+    std::string s;
+    for (auto _: state) {
+        state.PauseTiming();
+        const BigNumber x(random_float(digits), digits);
+        state.ResumeTiming();
+        x.ToString(s, digits);
+    }
+    state.SetComplexityN(state.range());
+}
+
+BENCHMARK(BM_BigNumber_construct)->Range(16, 1<<12)->Complexity();
+BENCHMARK(BM_BigNumber_construct_int)->Range(16, 1<<12)->Complexity();
+BENCHMARK(BM_BigNumber_Add)->Arg(10)->Range(16, 1<<12)->Complexity();
+BENCHMARK(BM_BigNumber_Multiply)->Arg(10)->Range(16, 1<<12)->Complexity();
+BENCHMARK(BM_BigNumber_Divide)->Arg(10)->Range(16, 1<<12)->Complexity();
+// 10 digits is the default precision, within reach of double, and 20
+// within reach of double-double
+BENCHMARK(BM_BigNumber_Exp)->Arg(10)->Arg(20)->Arg(100)->Arg(1000)->Complexity();
+BENCHMARK(BM_BigNumber_Sin)->Arg(10)->Arg(20)->Arg(100)->Arg(1000)->Complexity();
+BENCHMARK(BM_BigNumber_Sqrt)->Range(16, 1<<12)->Complexity();
+BENCHMARK(BM_BigNumber_ToString)->Range(16, 1<<12)->Complexity();
+
+BENCHMARK_MAIN();
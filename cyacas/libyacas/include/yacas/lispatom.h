@@ -16,6 +16,7 @@
  * The string is held in the number (to avoid repeated conversions) and also cached in the string cache (this caching will eventually be abandoned).
  * When LispNumber is constructed from BigNumber, no string representation is available.
  * Conversion from string to BigNumber is done only if no BigNumber object is present.
+ * Integers that fit in a machine word are kept as such, and get a BigNumber only when one is asked for.
  */
 
 #ifndef YACAS_LISPATOM_H
@@ -100,23 +101,35 @@ private:
 class LispNumber: public LispObject, public FastAlloc<LispNumber>
 {
 public:
+    /// integers of smaller magnitude are kept in a machine word; sums and
+    /// differences of two of them cannot overflow
+    static constexpr std::int64_t SMALL_LIMIT = std::int64_t(1) << 62;
+
     /// constructors:
     /// construct from another LispNumber
   LispNumber(BigNumber* aNumber) : iNumber(aNumber), iString(nullptr) {}
-  LispNumber(const LispNumber& other) : LispObject(other), iNumber(other.iNumber), iString(other.iString) {}
+  LispNumber(const LispNumber& other) : LispObject(other), iNumber(other.iNumber), iString(other.iString), iSmall(other.iSmall) {}
   /// construct from a decimal string representation (also create a number object) and use aBasePrecision decimal digits
-  LispNumber(LispString * aString, int aBasePrecision) : iNumber(nullptr), iString(aString) { Number(aBasePrecision); }
+  LispNumber(LispString * aString, int aBasePrecision);
+  /// construct a small integer, |aValue| < SMALL_LIMIT
+  explicit LispNumber(std::int64_t aValue) : iNumber(nullptr), iString(nullptr), iSmall(aValue) {}
+
+  /// whether aValue can be kept in a machine word
+  static bool IsSmall(std::int64_t aValue) { return aValue > -SMALL_LIMIT && aValue < SMALL_LIMIT; }
 
   LispObject* Copy() const override { return new LispNumber(*this); }
   /// return a string representation in decimal with maximum decimal precision allowed by the inherent accuracy of the number
   LispString * String() override;
   /// give access to the BigNumber object; if necessary, will create a BigNumber object out of the stored string, at given precision (in decimal?)
   BigNumber* Number(int aPrecision) override;
+  bool SmallInt(std::int64_t& aValue) override;
 private:
   /// number object; nullptr if not yet converted from string
   RefPtr<BigNumber> iNumber;
   /// string representation in decimal; nullptr if not yet converted from BigNumber
   RefPtr<LispString> iString;
+  /// the value of a small integer; the BigNumber is only made on demand
+  std::optional<std::int64_t> iSmall;
 };
 
 
@@ -18,6 +18,8 @@
 #include "genericobject.h"
 #include "noncopyable.h"
 
+#include <cstdint>
+
 class LispObject;
 class BigNumber;
 
@@ -60,6 +62,11 @@ public: //Derivables
    */
   virtual BigNumber* Number(int aPrecision) { return nullptr; }
 
+  /** If this is an integer kept in a machine word, put it in aValue and
+   *  return true; the arithmetic commands take a shortcut then.
+   */
+  virtual bool SmallInt(std::int64_t& aValue) { return false; }
+
   virtual LispObject* Copy() const = 0;
 
 public:
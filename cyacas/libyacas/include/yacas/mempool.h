@@ -3,41 +3,196 @@
 
 #include "noncopyable.h"
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 
+// Fixed size blocks carved out of slabs of SLAB_SIZE bytes, aligned to
+// their size, each beginning with a header; the slab owning a block is
+// found by masking the block's address. A pool belongs to a single
+// thread. Blocks it hands out may be freed on any thread: those freed
+// elsewhere are queued on their slab and collected by the owner when it
+// runs out of room. Empty slabs beyond a few are returned to the system,
+// and slabs still in use when their pool is destroyed are taken over by
+// the next pool of the same block size that needs one.
 class MemPool: NonCopyable {
 public:
-    explicit MemPool(unsigned block_size, unsigned no_blocks);
+    static constexpr std::size_t SLAB_SIZE = 64 * 1024;
+
+    struct Statistics {
+        std::size_t block_size;
+        // slabs held, and blocks in them
+        std::size_t no_slabs;
+        std::size_t no_blocks;
+        // blocks not given back, as far as the pool knows; blocks freed on
+        // other threads count until collected
+        std::size_t no_used_blocks;
+        std::size_t no_allocs;
+        std::size_t no_frees;
+        std::size_t no_slabs_allocated;
+        std::size_t no_slabs_released;
+        std::size_t no_slabs_adopted;
+    };
+
+    explicit MemPool(std::size_t block_size);
     ~MemPool() noexcept;
 
     void* alloc();
-    void free(void *p) noexcept;
+    // p may come from any pool, of any thread
+    void free(void* p) noexcept;
+
+    // give up all slabs, as the destructor does; the pool takes new ones
+    // if it is used again
+    void abandon() noexcept;
+
+    Statistics statistics() const;
 
 private:
-    unsigned _block_size;
-    unsigned _no_blocks;
+    struct Slab {
+        // the owner, or nothing while the slab is abandoned; other
+        // threads only compare it with their own pools
+        std::atomic<MemPool*> pool;
+
+        // in the owner's list of slabs, and in its stack of partial ones
+        Slab* prev;
+        Slab* next;
+        Slab* next_partial;
+        bool partial;
+
+        // blocks freed by the owner, and those never handed out
+        std::uint8_t* free;
+        std::uint8_t* untouched;
+        std::uint8_t* end;
+        std::size_t no_used;
+
+        // blocks freed on other threads
+        std::atomic<std::uint8_t*> remote;
+
+        // abandoned slabs waiting to be adopted
+        Slab* next_abandoned;
+        std::size_t block_size;
+    };
+
+    static std::uint8_t*& next_block(void* p)
+    {
+        return *static_cast<std::uint8_t**>(p);
+    }
 
-    unsigned _no_free_blocks;
-    unsigned _no_initialized_blocks;
+    // with more empty slabs than this, all but one are released
+    static constexpr std::size_t MAX_EMPTY_SLABS = 4;
 
-    std::uint8_t* _pool;
-    
-    std::uint8_t* _next_free_block;
-    
-    MemPool* _next_pool;
+    void* alloc_slow();
+    void free_remote(Slab* s, void* p) noexcept;
+    std::size_t collect(Slab* s) noexcept;
+    void add_slab(Slab* s) noexcept;
+    Slab* new_slab();
+    Slab* adopt_slab() noexcept;
+    void release_empty_slabs() noexcept;
+    void release_slab(Slab* s) noexcept;
+
+    std::size_t _block_size;
+    std::size_t _no_blocks;
+
+    // all slabs, and a stack of those with blocks to hand out; a slab
+    // joins the stack when a block of it is freed and leaves it when it
+    // runs out, without touching its neighbours
+    Slab* _slabs;
+    Slab* _partial;
+    std::size_t _no_empty;
+
+    Statistics _stats;
+
+    // slabs of destroyed pools still in use, of any block size
+    static Slab* _abandoned;
 };
 
+inline void* MemPool::alloc()
+{
+    Slab* s = _partial;
+
+    if (!s)
+        return alloc_slow();
+
+    std::uint8_t* p;
+
+    if (s->free) {
+        p = s->free;
+        s->free = next_block(p);
+    } else {
+        p = s->untouched;
+        s->untouched += _block_size;
+    }
+
+    if (!s->free && s->untouched == s->end) {
+        _partial = s->next_partial;
+        s->partial = false;
+    }
+
+    if (s->no_used++ == 0)
+        _no_empty -= 1;
+
+    _stats.no_allocs += 1;
+
+    return p;
+}
+
+inline void MemPool::free(void* p) noexcept
+{
+    if (!p)
+        return;
+
+    Slab* s = reinterpret_cast<Slab*>(
+        reinterpret_cast<std::uintptr_t>(p) & ~std::uintptr_t(SLAB_SIZE - 1));
+
+    if (s->pool.load(std::memory_order_relaxed) != this) {
+        free_remote(s, p);
+        return;
+    }
+
+    next_block(p) = s->free;
+    s->free = static_cast<std::uint8_t*>(p);
+
+    _stats.no_frees += 1;
+
+    if (!s->partial) {
+        s->next_partial = _partial;
+        s->partial = true;
+        _partial = s;
+    }
+
+    if (--s->no_used == 0 && ++_no_empty > MAX_EMPTY_SLABS)
+        release_empty_slabs();
+}
+
 template <typename T>
 class FastAlloc {
 public:
-    static void* operator new(std::size_t size) { return _pool.alloc(); }
-    static void operator delete(void* p) { _pool.free(p); }
+    static void* operator new(std::size_t) { return pool().alloc(); }
+    static void operator delete(void* p) { pool().free(p); }
+
+    // of the calling thread's pool
+    static MemPool::Statistics statistics() { return pool().statistics(); }
+
 private:
-    static MemPool _pool;
-};
+    struct Abandon {
+        MemPool* pool;
+        ~Abandon() { pool->abandon(); }
+    };
 
-template <typename T>
-MemPool FastAlloc<T>::_pool(sizeof (T), 32768);
+    // The pool is never destroyed, so that objects deleted by destructors
+    // of thread-locals and statics, which may run after its thread has
+    // exited, still find it; its slabs are handed on when the thread exits.
+    static MemPool& pool()
+    {
+        static thread_local MemPool* pool = nullptr;
+
+        if (!pool) {
+            pool = new MemPool(sizeof (T));
+            static thread_local Abandon abandon = {pool};
+        }
+
+        return *pool;
+    }
+};
 
 #endif
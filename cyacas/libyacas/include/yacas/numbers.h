@@ -2,23 +2,30 @@
 #define YACAS_NUMBERS_H
 
 #include "lispenvironment.h"
-#include "anumber.h"
 #include "refcount.h"
 #include "yacas/mp/zz.hpp"
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 
 using namespace yacas;
 
 LispObject* GcdInteger(LispObject* int1, LispObject* int2, LispEnvironment& aEnvironment);
+LispObject* ExtendedGcdInteger(LispObject* int1, LispObject* int2, LispEnvironment& aEnvironment);
+LispObject* PowerModInteger(LispObject* int1, LispObject* int2, LispObject* int3, LispEnvironment& aEnvironment);
+LispObject* IntSqrtInteger(LispObject* int1, LispEnvironment& aEnvironment);
+LispObject* IntNthRootInteger(LispObject* int1, LispObject* int2, LispEnvironment& aEnvironment);
+LispObject* PerfectPowerInteger(LispObject* int1, LispEnvironment& aEnvironment);
 LispObject* ModFloat( LispObject* int1, LispObject* int2, LispEnvironment& aEnvironment,
                         int aPrecision);
 
-LispObject* PowerFloat(LispObject* int1, LispObject* int2,
-                         LispEnvironment& aEnvironment,int aPrecision);
 LispObject* ShiftLeft( LispObject* int1, LispObject* int2, LispEnvironment& aEnvironment,int aPrecision);
 LispObject* ShiftRight( LispObject* int1, LispObject* int2, LispEnvironment& aEnvironment,int aPrecision);
 LispObject* LispFactorial(LispObject* int1, LispEnvironment& aEnvironment,int aPrecision);
+LispObject* DoubleFactorialInteger(LispObject* int1, LispEnvironment& aEnvironment);
+LispObject* BinomialInteger(LispObject* int1, LispObject* int2, LispEnvironment& aEnvironment);
+LispObject* PartialFactorialInteger(LispObject* int1, LispObject* int2, LispEnvironment& aEnvironment);
 
 /** Base number class.
  */
@@ -26,10 +33,13 @@ LispObject* LispFactorial(LispObject* int1, LispEnvironment& aEnvironment,int aP
 
 /// Main class for multiple-precision arithmetic.
 /// All calculations are done at given precision. Integers grow as needed, floats don't grow beyond given precision.
+/// Floats are binary, a mantissa times a power of two; decimal digits only
+/// come into play when a float is parsed or printed.
 class BigNumber: public RefCount {
 public: //constructors
     BigNumber(const std::string& aString,int aPrecision,int aBase=10);
     explicit BigNumber(const mp::ZZ& zz);
+    explicit BigNumber(std::int64_t);
     /// copy constructor
     explicit BigNumber(const BigNumber& aOther);
 
@@ -52,10 +62,29 @@ public: //constructors
     void Multiply(const BigNumber& aX, const BigNumber& aY, int aPrecision);
     /// Add two numbers at given precision and return result in *this
     void Add(const BigNumber& aX, const BigNumber& aY, int aPrecision);
+    /// Add the product of two numbers to *this at given precision
+    void MultiplyAdd(const BigNumber& aX, const BigNumber& aY, int aPrecision);
     /// Negate the given number, return result in *this
     void Negate(const BigNumber& aX);
     /// Divide two numbers and return result in *this. Note: if the two arguments are integer, it should return an integer result!
     void Divide(const BigNumber& aX, const BigNumber& aY, int aPrecision);
+    /// Divide two integers, the second known to divide the first, and return result in *this
+    void DivideExact(const BigNumber& aX, const BigNumber& aY);
+
+    /// Elementary functions of aX at given precision, return result in *this
+    void Exp(const BigNumber& aX, int aPrecision);
+    void Ln(const BigNumber& aX, int aPrecision);
+    void Sin(const BigNumber& aX, int aPrecision);
+    void Cos(const BigNumber& aX, int aPrecision);
+    void Tan(const BigNumber& aX, int aPrecision);
+    void ArcSin(const BigNumber& aX, int aPrecision);
+    void ArcTan(const BigNumber& aX, int aPrecision);
+    void Sqrt(const BigNumber& aX, int aPrecision);
+    /// aX to the power aY at given precision, return result in *this
+    void Power(const BigNumber& aX, const BigNumber& aY, int aPrecision);
+    /// Pi and Euler's constant at given precision, in *this
+    void Pi(int aPrecision);
+    void EulerGamma(int aPrecision);
 
     /// For debugging purposes, dump internal state of this object into a string
     void DumpDebugInfo(std::ostream&) const;
@@ -82,14 +111,40 @@ public: //constructors
     inline int GetPrecision() const {return iPrecision;};
 
 private:
+    /// whether the number is an integer or a float with an integer value
+    bool IsIntegral() const;
+
+    /// the float as _man 2^_exp, or the integer with exponent 0
+    const mp::ZZ& Mantissa() const { return _zz ? *_zz : _man; }
+    long Exponent() const { return _zz ? 0 : _exp; }
+    /// become the float aMantissa 2^aExponent of precision aPrecision
+    void SetFloat(mp::ZZ aMantissa, long aExponent, int aPrecision);
+    /// become aValue, if an error of aError 2^-53 leaves it good to
+    /// aPrecision bits and a few more; report whether it did
+    bool SetDouble(double aValue, double aError, int aPrecision);
+    /// likewise aHi + aLo, with an error of aError 2^-106
+    bool SetDoubleDouble(double aHi, double aLo, double aError, int aPrecision);
+
     int iPrecision;
 
     friend LispObject* GcdInteger(LispObject* int1, LispObject* int2, LispEnvironment& aEnvironment);
+    friend LispObject* ExtendedGcdInteger(LispObject* int1, LispObject* int2, LispEnvironment& aEnvironment);
+    friend LispObject* PowerModInteger(LispObject* int1, LispObject* int2, LispObject* int3, LispEnvironment& aEnvironment);
+    friend LispObject* IntSqrtInteger(LispObject* int1, LispEnvironment& aEnvironment);
+    friend LispObject* IntNthRootInteger(LispObject* int1, LispObject* int2, LispEnvironment& aEnvironment);
+    friend LispObject* PerfectPowerInteger(LispObject* int1, LispEnvironment& aEnvironment);
+    friend LispObject* LispFactorial(LispObject* int1, LispEnvironment& aEnvironment,int aPrecision);
+    friend LispObject* DoubleFactorialInteger(LispObject* int1, LispEnvironment& aEnvironment);
+    friend LispObject* BinomialInteger(LispObject* int1, LispObject* int2, LispEnvironment& aEnvironment);
+    friend LispObject* PartialFactorialInteger(LispObject* int1, LispObject* int2, LispEnvironment& aEnvironment);
     friend LispObject* SqrtFloat(LispObject* int1, LispEnvironment& aEnvironment,int aPrecision);
-    friend LispObject* PowerFloat(LispObject* int1, LispObject* int2, LispEnvironment& aEnvironment,int aPrecision);
+    friend LispObject* ModFloat(LispObject* int1, LispObject* int2, LispEnvironment& aEnvironment, int aPrecision);
 
-    std::unique_ptr<ANumber> iNumber;
-    std::unique_ptr<mp::ZZ> _zz;
+    // floats are _man 2^_exp, with the precision in bits in iPrecision;
+    // integers are kept in _zz instead
+    mp::ZZ _man;
+    long _exp;
+    std::optional<mp::ZZ> _zz;
 };
 
 /// bits_to_digits and digits_to_bits, utility functions
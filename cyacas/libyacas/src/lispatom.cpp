@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cctype>
 
 /// construct an atom from a string representation.
 LispObject* LispAtom::New(LispEnvironment& aEnvironment,
@@ -96,10 +97,28 @@ GenericClass* LispGenericClass::Generic()
 //------------------------------------------------------------------------------
 // LispNumber methods - proceed at your own risk
 
+LispNumber::LispNumber(LispString* aString, int aBasePrecision) :
+    iNumber(nullptr),
+    iString(aString)
+{
+    // up to 18 decimal digits stay below SMALL_LIMIT
+    const std::string& s = *aString;
+    const std::size_t n = s.size() - (!s.empty() && s[0] == '-');
+    if (n > 0 && n <= 18 &&
+        std::all_of(s.end() - n, s.end(), [](unsigned char c) { return std::isdigit(c); })) {
+        iSmall = std::stoll(s);
+        return;
+    }
+
+    Number(aBasePrecision);
+}
+
 /// return a string representation in decimal
 LispString* LispNumber::String()
 {
-    if (!iString) {
+    if (!iString && iSmall) {
+        iString = new LispString(std::to_string(*iSmall));
+    } else if (!iString) {
         assert(
             iNumber
                 .ptr()); // either the string is null or the number but not both
@@ -121,7 +140,9 @@ LispString* LispNumber::String()
 // BigNumber object is already present
 BigNumber* LispNumber::Number(int aBasePrecision)
 {
-    if (!iNumber) { // create and store a BigNumber out of string
+    if (!iNumber && iSmall) {
+        iNumber = new BigNumber(*iSmall);
+    } else if (!iNumber) { // create and store a BigNumber out of string
         assert(iString.ptr());
         // aBasePrecision is in digits, not in bits, ok
         iNumber = new BigNumber(*iString, aBasePrecision, BASE10);
@@ -137,3 +158,12 @@ BigNumber* LispNumber::Number(int aBasePrecision)
     }
     return iNumber;
 }
+
+bool LispNumber::SmallInt(std::int64_t& aValue)
+{
+    if (!iSmall)
+        return false;
+
+    aValue = *iSmall;
+    return true;
+}
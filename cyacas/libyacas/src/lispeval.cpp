@@ -63,7 +63,11 @@ void BasicEvaluator::Eval(LispEnvironment& aEnvironment,
         throw LispErrMaxRecurseDepthReached();
     }
 
-    const LispString* str = aExpression->String();
+    // a small integer evaluates to itself; looking it up as a variable
+    // would need its string representation
+    std::int64_t n;
+    const LispString* str =
+        aExpression->SmallInt(n) ? nullptr : aExpression->String();
 
     // Evaluate an atom: find the bound value (treat it as a variable)
     if (str) {
@@ -162,11 +162,23 @@ void LispStrictTotalOrder(LispEnvironment& aEnvironment, int aStackTop)
 
 void LispLessThan(LispEnvironment& aEnvironment, int aStackTop)
 {
+    std::int64_t a, b;
+    if (ARGUMENT(1)->SmallInt(a) && ARGUMENT(2)->SmallInt(b)) {
+        InternalBoolean(aEnvironment, RESULT, a < b);
+        return;
+    }
+
     LispLexCompare2(aEnvironment, aStackTop, LexLessThan, BigLessThan);
 }
 
 void LispGreaterThan(LispEnvironment& aEnvironment, int aStackTop)
 {
+    std::int64_t a, b;
+    if (ARGUMENT(1)->SmallInt(a) && ARGUMENT(2)->SmallInt(b)) {
+        InternalBoolean(aEnvironment, RESULT, a > b);
+        return;
+    }
+
     LispLexCompare2(aEnvironment, aStackTop, LexGreaterThan, BigGreaterThan);
 }
 
@@ -19,6 +19,7 @@
 #include "yacas/substitute.h"
 
 #include <cmath>
+#include <cstdlib>
 
 #include "yacas/yacas_version.h"
 
@@ -43,49 +44,6 @@ void GetNumber(RefPtr<BigNumber>& x,
     CheckArg(x, aArgNr, aEnvironment, aStackTop);
 }
 
-// FIXME remove these
-void LispArithmetic2(LispEnvironment& aEnvironment,
-                     int aStackTop,
-                     LispObject* (*func)(LispObject* f1,
-                                         LispObject* f2,
-                                         LispEnvironment& aEnvironment,
-                                         int aPrecision),
-                     bool arbbase = false);
-
-void LispArithmetic1(LispEnvironment& aEnvironment,
-                     int aStackTop,
-                     LispObject* (*func)(LispObject* f1,
-                                         LispEnvironment& aEnvironment,
-                                         int aPrecision));
-
-// FIXME remove these
-void LispArithmetic1(LispEnvironment& aEnvironment,
-                     int aStackTop,
-                     LispObject* (*func)(LispObject* f1,
-                                         LispEnvironment& aEnvironment,
-                                         int aPrecision))
-{
-    CheckArg(ARGUMENT(1)->Number(0), 1, aEnvironment, aStackTop);
-    RESULT = (func(ARGUMENT(1), aEnvironment, aEnvironment.Precision()));
-}
-
-// FIXME remove these
-void LispArithmetic2(LispEnvironment& aEnvironment,
-                     int aStackTop,
-                     LispObject* (*func)(LispObject* f1,
-                                         LispObject* f2,
-                                         LispEnvironment& aEnvironment,
-                                         int aPrecision),
-                     bool arbbase)
-{
-    if (!arbbase) {
-        CheckArg(ARGUMENT(1)->Number(0), 1, aEnvironment, aStackTop);
-        CheckArg(ARGUMENT(2)->Number(0), 2, aEnvironment, aStackTop);
-    }
-    RESULT = (func(
-        ARGUMENT(1), ARGUMENT(2), aEnvironment, aEnvironment.Precision()));
-}
-
 void LispDumpBigNumberDebugInfo(LispEnvironment& aEnvironment, int aStackTop)
 {
     RefPtr<BigNumber> x;
@@ -96,6 +54,13 @@ void LispDumpBigNumberDebugInfo(LispEnvironment& aEnvironment, int aStackTop)
 
 void LispMultiply(LispEnvironment& aEnvironment, int aStackTop)
 {
+    std::int64_t a, b;
+    if (ARGUMENT(1)->SmallInt(a) && ARGUMENT(2)->SmallInt(b) &&
+        (b == 0 || std::abs(a) < LispNumber::SMALL_LIMIT / std::abs(b))) {
+        RESULT = new LispNumber(a * b);
+        return;
+    }
+
     RefPtr<BigNumber> x;
     RefPtr<BigNumber> y;
     GetNumber(x, aEnvironment, aStackTop, 1);
@@ -107,6 +72,30 @@ void LispMultiply(LispEnvironment& aEnvironment, int aStackTop)
     return;
 }
 
+void LispMultiplyAdd(LispEnvironment& aEnvironment, int aStackTop)
+{
+    RefPtr<BigNumber> x;
+    RefPtr<BigNumber> y;
+    RefPtr<BigNumber> z;
+    GetNumber(x, aEnvironment, aStackTop, 1);
+    GetNumber(y, aEnvironment, aStackTop, 2);
+    GetNumber(z, aEnvironment, aStackTop, 3);
+    BigNumber* r = new BigNumber(*x);
+    r->MultiplyAdd(*y, *z, aEnvironment.BinaryPrecision());
+    RESULT = new LispNumber(r);
+}
+
+void LispDivideExact(LispEnvironment& aEnvironment, int aStackTop)
+{
+    RefPtr<BigNumber> x;
+    RefPtr<BigNumber> y;
+    GetNumber(x, aEnvironment, aStackTop, 1);
+    GetNumber(y, aEnvironment, aStackTop, 2);
+    BigNumber* z = new BigNumber("0", 0);
+    z->DivideExact(*x, *y);
+    RESULT = new LispNumber(z);
+}
+
 // TODO we need to have Gcd in BigNumber!
 void LispGcd(LispEnvironment& aEnvironment, int aStackTop)
 {
@@ -116,16 +105,65 @@ void LispGcd(LispEnvironment& aEnvironment, int aStackTop)
     RESULT = (GcdInteger(ARGUMENT(1), ARGUMENT(2), aEnvironment));
 }
 
+void LispExtendedGcd(LispEnvironment& aEnvironment, int aStackTop)
+{
+    CheckArg(ARGUMENT(1)->Number(0), 1, aEnvironment, aStackTop);
+    CheckArg(ARGUMENT(2)->Number(0), 2, aEnvironment, aStackTop);
+
+    RESULT = (ExtendedGcdInteger(ARGUMENT(1), ARGUMENT(2), aEnvironment));
+}
+
+void LispPowerMod(LispEnvironment& aEnvironment, int aStackTop)
+{
+    CheckArg(ARGUMENT(1)->Number(0), 1, aEnvironment, aStackTop);
+    CheckArg(ARGUMENT(2)->Number(0), 2, aEnvironment, aStackTop);
+    CheckArg(ARGUMENT(3)->Number(0), 3, aEnvironment, aStackTop);
+
+    RESULT = (PowerModInteger(
+        ARGUMENT(1), ARGUMENT(2), ARGUMENT(3), aEnvironment));
+}
+
+void LispIntSqrt(LispEnvironment& aEnvironment, int aStackTop)
+{
+    CheckArg(ARGUMENT(1)->Number(0), 1, aEnvironment, aStackTop);
+
+    RESULT = (IntSqrtInteger(ARGUMENT(1), aEnvironment));
+}
+
+void LispIntNthRoot(LispEnvironment& aEnvironment, int aStackTop)
+{
+    CheckArg(ARGUMENT(1)->Number(0), 1, aEnvironment, aStackTop);
+    CheckArg(ARGUMENT(2)->Number(0), 2, aEnvironment, aStackTop);
+
+    RESULT = (IntNthRootInteger(ARGUMENT(1), ARGUMENT(2), aEnvironment));
+}
+
+void LispPerfectPower(LispEnvironment& aEnvironment, int aStackTop)
+{
+    CheckArg(ARGUMENT(1)->Number(0), 1, aEnvironment, aStackTop);
+
+    RESULT = (PerfectPowerInteger(ARGUMENT(1), aEnvironment));
+}
+
 /// Corresponds to the Yacas function \c MathAdd.
 /// If called with one argument (unary plus), this argument is
 /// converted to BigNumber. If called with two arguments (binary plus),
 /// both argument are converted to a BigNumber, and these are added
 /// together at the current precision. The sum is returned.
+/// Integers kept in a machine word are added as such while the sum fits.
 /// \sa GetNumber(), BigNumber::Add()
 void LispAdd(LispEnvironment& aEnvironment, int aStackTop)
 {
     int length = InternalListLength(ARGUMENT(0));
-    if (length == 2) {
+    std::int64_t a, b;
+    if (length == 2 && ARGUMENT(1)->SmallInt(a)) {
+        RESULT = new LispNumber(a);
+        return;
+    } else if (length == 3 && ARGUMENT(1)->SmallInt(a) &&
+               ARGUMENT(2)->SmallInt(b) && LispNumber::IsSmall(a + b)) {
+        RESULT = new LispNumber(a + b);
+        return;
+    } else if (length == 2) {
         RefPtr<BigNumber> x;
         GetNumber(x, aEnvironment, aStackTop, 1);
         RESULT = (new LispNumber(x.ptr()));
@@ -146,7 +184,15 @@ void LispAdd(LispEnvironment& aEnvironment, int aStackTop)
 void LispSubtract(LispEnvironment& aEnvironment, int aStackTop)
 {
     int length = InternalListLength(ARGUMENT(0));
-    if (length == 2) {
+    std::int64_t a, b;
+    if (length == 2 && ARGUMENT(1)->SmallInt(a)) {
+        RESULT = new LispNumber(-a);
+        return;
+    } else if (length == 3 && ARGUMENT(1)->SmallInt(a) &&
+               ARGUMENT(2)->SmallInt(b) && LispNumber::IsSmall(a - b)) {
+        RESULT = new LispNumber(a - b);
+        return;
+    } else if (length == 2) {
         RefPtr<BigNumber> x;
         GetNumber(x, aEnvironment, aStackTop, 1);
         BigNumber* z = new BigNumber(*x);
@@ -243,9 +289,8 @@ void LispGetExactBits(LispEnvironment& aEnvironment, int aStackTop)
 {
     RefPtr<BigNumber> x;
     GetNumber(x, aEnvironment, aStackTop, 1);
-    BigNumber* z = new BigNumber(
-        std::to_string(x->IsInt() ? x->BitCount() : x->GetPrecision()),
-        aEnvironment.BinaryPrecision());
+    BigNumber* z = new BigNumber(static_cast<std::int64_t>(
+        x->IsInt() ? x->BitCount() : x->GetPrecision()));
     RESULT = (new LispNumber(z));
 }
 /// set internal precision data on a number object.
@@ -267,8 +312,7 @@ void LispBitCount(LispEnvironment& aEnvironment, int aStackTop)
 {
     RefPtr<BigNumber> x;
     GetNumber(x, aEnvironment, aStackTop, 1);
-    BigNumber* z = new BigNumber(std::to_string(x->BitCount()),
-                                 aEnvironment.BinaryPrecision());
+    BigNumber* z = new BigNumber(static_cast<std::int64_t>(x->BitCount()));
     RESULT = (new LispNumber(z));
 }
 
@@ -277,8 +321,7 @@ void LispMathSign(LispEnvironment& aEnvironment, int aStackTop)
 {
     RefPtr<BigNumber> x;
     GetNumber(x, aEnvironment, aStackTop, 1);
-    BigNumber* z = new BigNumber(std::to_string(x->Sign()),
-                                 aEnvironment.BinaryPrecision());
+    BigNumber* z = new BigNumber(static_cast<std::int64_t>(x->Sign()));
     RESULT = (new LispNumber(z));
 }
 
@@ -311,13 +354,14 @@ void LispAbs(LispEnvironment& aEnvironment, int aStackTop)
         z->Negate(*x);
     RESULT = (new LispNumber(z));
 }
-// BINARYFUNCTION(LispMod, Mod, ModFloat)
-/* this will be gone */
 void LispMod(LispEnvironment& aEnvironment, int aStackTop)
-{ // FIXME
-    LispArithmetic2(aEnvironment, aStackTop, ModFloat);
+{
+    CheckArg(ARGUMENT(1)->Number(0), 1, aEnvironment, aStackTop);
+    CheckArg(ARGUMENT(2)->Number(0), 2, aEnvironment, aStackTop);
+
+    RESULT = (ModFloat(
+        ARGUMENT(1), ARGUMENT(2), aEnvironment, aEnvironment.Precision()));
 }
-/* up to here */
 
 void LispDiv(LispEnvironment& aEnvironment, int aStackTop)
 {
@@ -337,14 +381,34 @@ void LispDiv(LispEnvironment& aEnvironment, int aStackTop)
     RESULT = (new LispNumber(z));
 }
 
-void LispPower(LispEnvironment& aEnvironment, int aStackTop)
-{ // FIXME move to scripts
-    LispArithmetic2(aEnvironment, aStackTop, PowerFloat);
+void LispFac(LispEnvironment& aEnvironment, int aStackTop)
+{
+    CheckArg(ARGUMENT(1)->Number(0), 1, aEnvironment, aStackTop);
+
+    RESULT = (LispFactorial(ARGUMENT(1), aEnvironment, aEnvironment.Precision()));
+}
+
+void LispDoubleFac(LispEnvironment& aEnvironment, int aStackTop)
+{
+    CheckArg(ARGUMENT(1)->Number(0), 1, aEnvironment, aStackTop);
+
+    RESULT = (DoubleFactorialInteger(ARGUMENT(1), aEnvironment));
 }
 
-void LispFac(LispEnvironment& aEnvironment, int aStackTop)
-{ // FIXME move to scripts
-    LispArithmetic1(aEnvironment, aStackTop, LispFactorial);
+void LispBin(LispEnvironment& aEnvironment, int aStackTop)
+{
+    CheckArg(ARGUMENT(1)->Number(0), 1, aEnvironment, aStackTop);
+    CheckArg(ARGUMENT(2)->Number(0), 2, aEnvironment, aStackTop);
+
+    RESULT = (BinomialInteger(ARGUMENT(1), ARGUMENT(2), aEnvironment));
+}
+
+void LispPartialFac(LispEnvironment& aEnvironment, int aStackTop)
+{
+    CheckArg(ARGUMENT(1)->Number(0), 1, aEnvironment, aStackTop);
+    CheckArg(ARGUMENT(2)->Number(0), 2, aEnvironment, aStackTop);
+
+    RESULT = (PartialFactorialInteger(ARGUMENT(1), ARGUMENT(2), aEnvironment));
 }
 
 // platform functions, taking/returning a platform int/float
@@ -354,8 +418,7 @@ void LispFastIsPrime(LispEnvironment& aEnvironment, int aStackTop)
     RefPtr<BigNumber> x;
     GetNumber(x, aEnvironment, aStackTop, 1);
     long result = primes_table_check((unsigned long)(x->Double()));
-    BigNumber* z =
-        new BigNumber(std::to_string(result), aEnvironment.BinaryPrecision());
+    BigNumber* z = new BigNumber(static_cast<std::int64_t>(result));
     RESULT = (new LispNumber(z));
 }
 
@@ -366,8 +429,11 @@ void LispFastIsPrime(LispEnvironment& aEnvironment, int aStackTop)
     {                                                                          \
         RefPtr<BigNumber> x;                                                   \
         GetNumber(x, aEnvironment, aStackTop, 1);                              \
+        const double r = PlatformName(x->Double());                            \
+        if (!std::isfinite(r))                                                 \
+            throw LispErrInvalidArg();                                         \
         std::ostringstream buf;                                                \
-        buf << std::setprecision(53) << PlatformName(x->Double());             \
+        buf << std::setprecision(53) << r;                                     \
         BigNumber* z =                                                         \
             new BigNumber(buf.str(), aEnvironment.BinaryPrecision());          \
         RESULT = (new LispNumber(z));                                          \
@@ -379,9 +445,11 @@ void LispFastIsPrime(LispEnvironment& aEnvironment, int aStackTop)
         RefPtr<BigNumber> x, y;                                                \
         GetNumber(x, aEnvironment, aStackTop, 1);                              \
         GetNumber(y, aEnvironment, aStackTop, 2);                              \
+        const double r = PlatformName(x->Double(), y->Double());               \
+        if (!std::isfinite(r))                                                 \
+            throw LispErrInvalidArg();                                         \
         std::ostringstream buf;                                                \
-        buf << std::setprecision(53)                                           \
-            << PlatformName(x->Double(), y->Double());                         \
+        buf << std::setprecision(53) << r;                                     \
         BigNumber* z =                                                         \
             new BigNumber(buf.str(), aEnvironment.BinaryPrecision());          \
         RESULT = (new LispNumber(z));                                          \
@@ -394,6 +462,70 @@ PLATFORM_UNARY(LispFastArcSin, std::asin, LispArcSin, PlatArcSin)
 PLATFORM_UNARY(LispFastLog, std::log, LispLn, PlatLn)
 PLATFORM_BINARY(LispFastPower, std::pow, LispPower, PlatPower)
 
+// elementary functions at the current precision; outside their domain,
+// e.g. MathLog(-1), the call is left unevaluated, as it was when they
+// were scripts
+#define ELEMENTARYFUNCTION(LispName, BigNumName)                               \
+    void LispName(LispEnvironment& aEnvironment, int aStackTop)                \
+    {                                                                          \
+        RefPtr<BigNumber> x;                                                   \
+        GetNumber(x, aEnvironment, aStackTop, 1);                              \
+        RefPtr<BigNumber> z(new BigNumber("0", 0));                            \
+        try {                                                                  \
+            z->BigNumName(*x, aEnvironment.BinaryPrecision());                 \
+        } catch (const LispErrInvalidArg&) {                                   \
+            LispPtr call(ARGUMENT(0)->Copy());                                 \
+            call->Nixed() = ARGUMENT(1)->Copy();                               \
+            RESULT = LispSubList::New(call);                                   \
+            return;                                                            \
+        }                                                                      \
+        RESULT = (new LispNumber(z));                                          \
+    }
+
+ELEMENTARYFUNCTION(LispMathExp, Exp)
+ELEMENTARYFUNCTION(LispMathLog, Ln)
+ELEMENTARYFUNCTION(LispMathSin, Sin)
+ELEMENTARYFUNCTION(LispMathCos, Cos)
+ELEMENTARYFUNCTION(LispMathTan, Tan)
+ELEMENTARYFUNCTION(LispMathArcSin, ArcSin)
+ELEMENTARYFUNCTION(LispMathArcTan, ArcTan)
+ELEMENTARYFUNCTION(LispMathSqrt, Sqrt)
+
+// Arguments that are not numbers and powers that are not real, such as
+// MathPower(-8.0, 1/3), give False, as they did when MathPower was a
+// script.
+void LispMathPower(LispEnvironment& aEnvironment, int aStackTop)
+{
+    RefPtr<BigNumber> x(ARGUMENT(1)->Number(aEnvironment.Precision()));
+    RefPtr<BigNumber> y(ARGUMENT(2)->Number(aEnvironment.Precision()));
+
+    if (x && y) {
+        RefPtr<BigNumber> z(new BigNumber("0", 0));
+        try {
+            z->Power(*x, *y, aEnvironment.BinaryPrecision());
+            RESULT = (new LispNumber(z));
+            return;
+        } catch (const LispErrInvalidArg&) {
+        }
+    }
+
+    InternalFalse(aEnvironment, RESULT);
+}
+
+void LispMathPi(LispEnvironment& aEnvironment, int aStackTop)
+{
+    RefPtr<BigNumber> z(new BigNumber("0", 0));
+    z->Pi(aEnvironment.BinaryPrecision());
+    RESULT = (new LispNumber(z));
+}
+
+void LispMathEulerGamma(LispEnvironment& aEnvironment, int aStackTop)
+{
+    RefPtr<BigNumber> z(new BigNumber("0", 0));
+    z->EulerGamma(aEnvironment.BinaryPrecision());
+    RESULT = (new LispNumber(z));
+}
+
 BINARYFUNCTION(LispBitAnd, BitAnd)
 BINARYFUNCTION(LispBitOr, BitOr)
 BINARYFUNCTION(LispBitXor, BitXor)
@@ -401,17 +533,51 @@ BINARYFUNCTION(LispBitXor, BitXor)
 // BitNot not yet in yacasapi etc.
 //BINARYFUNCTION(LispBitNot, BitNot, BitNot)
 */
-/* this will be gone */
 void LispShiftLeft(LispEnvironment& aEnvironment, int aStackTop)
-{ // FIXME
-    LispArithmetic2(aEnvironment, aStackTop, ShiftLeft);
+{
+    CheckArg(ARGUMENT(1)->Number(0), 1, aEnvironment, aStackTop);
+    CheckArg(ARGUMENT(2)->Number(0), 2, aEnvironment, aStackTop);
+
+    RESULT = (ShiftLeft(
+        ARGUMENT(1), ARGUMENT(2), aEnvironment, aEnvironment.Precision()));
 }
+
 void LispShiftRight(LispEnvironment& aEnvironment, int aStackTop)
-{ // FIXME
-    LispArithmetic2(aEnvironment, aStackTop, ShiftRight);
+{
+    CheckArg(ARGUMENT(1)->Number(0), 1, aEnvironment, aStackTop);
+    CheckArg(ARGUMENT(2)->Number(0), 2, aEnvironment, aStackTop);
+
+    RESULT = (ShiftRight(
+        ARGUMENT(1), ARGUMENT(2), aEnvironment, aEnvironment.Precision()));
 }
 
-/* up to here */
+namespace {
+    // an optional minus sign followed by at least one base b digit
+    bool IsIntegerInBase(const std::string& s, int b)
+    {
+        std::size_t i = !s.empty() && s.front() == '-' ? 1 : 0;
+
+        if (i == s.size())
+            return false;
+
+        for (; i < s.size(); ++i) {
+            const char c = s[i];
+            int d;
+            if (c >= '0' && c <= '9')
+                d = c - '0';
+            else if (c >= 'a' && c <= 'z')
+                d = c - 'a' + 10;
+            else if (c >= 'A' && c <= 'Z')
+                d = c - 'A' + 10;
+            else
+                return false;
+            if (d >= b)
+                return false;
+        }
+
+        return true;
+    }
+}
 
 void LispFromBase(LispEnvironment& aEnvironment, int aStackTop)
 {
@@ -441,12 +607,15 @@ void LispFromBase(LispEnvironment& aEnvironment, int aStackTop)
     CheckArg(InternalIsString(str2), 2, aEnvironment, aStackTop);
     str2 = aEnvironment.HashTable().LookUp(str2->substr(1, str2->length() - 2));
 
-    // convert using correct base
-    // FIXME: API breach, must pass precision in base digits and not in bits!
-    // if converting an integer, the precision argument is ignored,
-    // but if converting a float, need to use bits_to_digits(BinaryPrecision,
-    // base)
-    BigNumber* z = new BigNumber(*str2, aEnvironment.BinaryPrecision(), base);
+    // integers are read directly, in time close to linear in their length
+    if (IsIntegerInBase(*str2, base)) {
+        RESULT = new LispNumber(new BigNumber(mp::ZZ(*str2, base)));
+        return;
+    }
+
+    // convert using correct base; the precision is in digits of that base
+    BigNumber* z = new BigNumber(
+        *str2, bits_to_digits(aEnvironment.BinaryPrecision(), base), base);
     RESULT = (new LispNumber(z));
 }
 void LispToBase(LispEnvironment& aEnvironment, int aStackTop)
@@ -472,13 +641,10 @@ void LispToBase(LispEnvironment& aEnvironment, int aStackTop)
     RefPtr<BigNumber> x;
     GetNumber(x, aEnvironment, aStackTop, 2);
 
-    // convert using correct base
+    // convert using correct base; the precision is in digits of that base
     LispString str;
-    // FIXME: API breach, must pass precision in base digits and not in bits!
-    // if converting an integer, the precision argument is ignored,
-    // but if converting a float, need to use bits_to_digits(BinaryPrecision,
-    // base)
-    x->ToString(str, aEnvironment.BinaryPrecision(), base);
+    x->ToString(
+        str, bits_to_digits(aEnvironment.BinaryPrecision(), base), base);
     // Get unique string from hash table, and create an atom from it.
 
     RESULT = LispAtom::New(aEnvironment, stringify(str));
@@ -558,6 +724,58 @@ void LispGarbageCollect(LispEnvironment& aEnvironment, int aStackTop)
     InternalTrue(aEnvironment, RESULT);
 }
 
+namespace {
+    // {"name", {{"block_size", ...}, {"slabs", ...}, ...}}
+    LispObject* MemPoolStatistics(LispEnvironment& aEnvironment,
+                                  const std::string& aName,
+                                  const MemPool::Statistics& aStats)
+    {
+        const std::pair<const char*, std::size_t> fields[] = {
+            {"block_size", aStats.block_size},
+            {"slabs", aStats.no_slabs},
+            {"blocks", aStats.no_blocks},
+            {"used_blocks", aStats.no_used_blocks},
+            {"allocs", aStats.no_allocs},
+            {"frees", aStats.no_frees},
+            {"slabs_allocated", aStats.no_slabs_allocated},
+            {"slabs_released", aStats.no_slabs_released},
+            {"slabs_adopted", aStats.no_slabs_adopted}};
+
+        LispObject* stats = aEnvironment.iList->Copy();
+        for (const auto& f : fields) {
+            BigNumber* n = new BigNumber(static_cast<std::int64_t>(f.second));
+            stats =
+                LispObjectAdder(stats) +
+                LispObjectAdder(LispSubList::New(
+                    LispObjectAdder(aEnvironment.iList->Copy()) +
+                    LispObjectAdder(LispAtom::New(aEnvironment, stringify(f.first))) +
+                    LispObjectAdder(new LispNumber(n))));
+        }
+
+        return LispSubList::New(
+            LispObjectAdder(aEnvironment.iList->Copy()) +
+            LispObjectAdder(LispAtom::New(aEnvironment, stringify(aName))) +
+            LispObjectAdder(LispSubList::New(stats)));
+    }
+}
+
+/// the statistics of the calling thread's pools of atoms, lists, generic
+/// objects and numbers, as an association list
+void LispMemoryStatistics(LispEnvironment& aEnvironment, int aStackTop)
+{
+    RESULT = LispSubList::New(
+        LispObjectAdder(aEnvironment.iList->Copy()) +
+        LispObjectAdder(MemPoolStatistics(
+            aEnvironment, "LispAtom", FastAlloc<LispAtom>::statistics())) +
+        LispObjectAdder(MemPoolStatistics(
+            aEnvironment, "LispSubList", FastAlloc<LispSubList>::statistics())) +
+        LispObjectAdder(MemPoolStatistics(aEnvironment,
+                                          "LispGenericClass",
+                                          FastAlloc<LispGenericClass>::statistics())) +
+        LispObjectAdder(MemPoolStatistics(
+            aEnvironment, "LispNumber", FastAlloc<LispNumber>::statistics())));
+}
+
 void LispPatchLoad(LispEnvironment& aEnvironment, int aStackTop)
 {
     LispPtr evaluated(ARGUMENT(1));
@@ -766,8 +984,7 @@ void LispBitsToDigits(LispEnvironment& aEnvironment, int aStackTop)
             << y->Double() << " must be small integers";
         throw LispErrGeneric(buf.str());
     }
-    BigNumber* z =
-        new BigNumber(std::to_string(result), aEnvironment.BinaryPrecision());
+    BigNumber* z = new BigNumber(static_cast<std::int64_t>(result));
     RESULT = (new LispNumber(z));
 }
 
@@ -790,7 +1007,6 @@ void LispDigitsToBits(LispEnvironment& aEnvironment, int aStackTop)
             << y->Double() << " must be small integers";
         throw LispErrGeneric(buf.str());
     }
-    BigNumber* z =
-        new BigNumber(std::to_string(result), aEnvironment.BinaryPrecision());
+    BigNumber* z = new BigNumber(static_cast<std::int64_t>(result));
     RESULT = (new LispNumber(z));
 }
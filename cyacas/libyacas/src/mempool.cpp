@@ -2,64 +2,250 @@
 
 #include <algorithm>
 #include <cassert>
+#include <mutex>
+#include <new>
 
-MemPool::MemPool(unsigned block_size, unsigned no_blocks) :
-    _block_size(std::max(static_cast<std::size_t>(block_size), sizeof(void*))),
-    _no_blocks(no_blocks),
-    _no_free_blocks(no_blocks),
-    _no_initialized_blocks(0),
-    _pool(new std::uint8_t[_block_size * _no_blocks]),
-    _next_free_block(_pool),
-    _next_pool(nullptr)
+namespace {
+    std::mutex abandoned_mutex;
+    std::atomic<bool> any_abandoned(false);
+}
+
+MemPool::Slab* MemPool::_abandoned = nullptr;
+
+MemPool::MemPool(std::size_t block_size) :
+    _block_size(std::max(block_size, sizeof(void*))),
+    _no_blocks((SLAB_SIZE - sizeof(Slab)) / _block_size),
+    _slabs(nullptr),
+    _partial(nullptr),
+    _no_empty(0),
+    _stats()
 {
+    assert(_no_blocks > 0);
+
+    _stats.block_size = _block_size;
 }
 
 MemPool::~MemPool() noexcept
 {
-    assert(_no_free_blocks == _no_blocks);
+    abandon();
+}
 
-    delete _next_pool;
-    delete[] _pool;
+// Slabs with blocks still in use are left for another pool to adopt;
+// blocks freed from now on are queued on them like any freed elsewhere.
+void MemPool::abandon() noexcept
+{
+    while (Slab* s = _slabs) {
+        _slabs = s->next;
+
+        collect(s);
+
+        if (s->no_used == 0) {
+            release_slab(s);
+            continue;
+        }
+
+        s->pool.store(nullptr, std::memory_order_relaxed);
+
+        _stats.no_slabs -= 1;
+        _stats.no_blocks -= _no_blocks;
+
+        std::lock_guard<std::mutex> lock(abandoned_mutex);
+        s->next_abandoned = _abandoned;
+        _abandoned = s;
+        any_abandoned.store(true, std::memory_order_relaxed);
+    }
+
+    _partial = nullptr;
+    _no_empty = 0;
 }
 
-void* MemPool::alloc()
+// All slabs are full; collect the blocks freed on other threads before
+// taking on another slab.
+void* MemPool::alloc_slow()
 {
-    if (_no_free_blocks) {
-        if (_no_initialized_blocks <= _no_blocks - _no_free_blocks) {
-            std::uint8_t* p = _pool + _no_initialized_blocks * _block_size;
-            *reinterpret_cast<std::uint8_t**>(p) = p + _block_size;
-            _no_initialized_blocks += 1;
+    for (Slab* s = _slabs; s; s = s->next) {
+        if (collect(s)) {
+            s->next_partial = _partial;
+            s->partial = true;
+            _partial = s;
         }
+    }
 
-        void* ret = _next_free_block;
+    while (!_partial) {
+        Slab* s = adopt_slab();
+        if (!s)
+            s = new_slab();
+        add_slab(s);
+    }
 
-        if (--_no_free_blocks)
-            _next_free_block =
-                *reinterpret_cast<std::uint8_t**>(_next_free_block);
-        else
-            _next_free_block = nullptr;
+    if (_no_empty > MAX_EMPTY_SLABS)
+        release_empty_slabs();
+
+    return alloc();
+}
+
+// Blocks freed on other threads are pushed on a stack of the slab's,
+// without a lock.
+void MemPool::free_remote(Slab* s, void* p) noexcept
+{
+    std::uint8_t* head = s->remote.load(std::memory_order_relaxed);
+    do {
+        next_block(p) = head;
+    } while (!s->remote.compare_exchange_weak(head,
+                                              static_cast<std::uint8_t*>(p),
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+}
+
+// Move the blocks freed on other threads to the slab's own free list;
+// return how many there were.
+std::size_t MemPool::collect(Slab* s) noexcept
+{
+    std::uint8_t* p = s->remote.exchange(nullptr, std::memory_order_acquire);
+
+    std::size_t n = 0;
+    while (p) {
+        std::uint8_t* next = next_block(p);
+        next_block(p) = s->free;
+        s->free = p;
+        p = next;
+        n += 1;
+    }
+
+    s->no_used -= n;
+
+    if (n && s->pool.load(std::memory_order_relaxed) == this) {
+        _stats.no_frees += n;
+        if (s->no_used == 0)
+            _no_empty += 1;
+    }
+
+    return n;
+}
+
+// A slab of this pool's, new or adopted, joins its list, and its stack if
+// it has blocks to hand out.
+void MemPool::add_slab(Slab* s) noexcept
+{
+    s->prev = nullptr;
+    s->next = _slabs;
+    if (_slabs)
+        _slabs->prev = s;
+    _slabs = s;
+
+    s->partial = s->free || s->untouched != s->end;
+    if (s->partial) {
+        s->next_partial = _partial;
+        _partial = s;
+    }
+
+    if (s->no_used == 0)
+        _no_empty += 1;
 
-        return ret;
+    _stats.no_slabs += 1;
+    _stats.no_blocks += _no_blocks;
+}
+
+MemPool::Slab* MemPool::new_slab()
+{
+    void* m = ::operator new(SLAB_SIZE, std::align_val_t(SLAB_SIZE));
+
+    Slab* s = new (m) Slab;
+    s->pool.store(this, std::memory_order_relaxed);
+    s->free = nullptr;
+    // the blocks end the slab, so they are as aligned as their size is
+    s->end = static_cast<std::uint8_t*>(m) + SLAB_SIZE;
+    s->untouched = s->end - _no_blocks * _block_size;
+    s->no_used = 0;
+    s->remote.store(nullptr, std::memory_order_relaxed);
+    s->next_abandoned = nullptr;
+    s->block_size = _block_size;
+
+    _stats.no_slabs_allocated += 1;
+
+    return s;
+}
+
+MemPool::Slab* MemPool::adopt_slab() noexcept
+{
+    if (!any_abandoned.load(std::memory_order_relaxed))
+        return nullptr;
+
+    Slab* s = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(abandoned_mutex);
+
+        for (Slab** q = &_abandoned; *q; q = &(*q)->next_abandoned) {
+            if ((*q)->block_size == _block_size) {
+                s = *q;
+                *q = s->next_abandoned;
+                break;
+            }
+        }
+
+        any_abandoned.store(_abandoned != nullptr, std::memory_order_relaxed);
     }
 
-    if (!_next_pool)
-        _next_pool = new MemPool(_block_size, _no_blocks);
+    if (!s)
+        return nullptr;
+
+    // blocks freed while the slab was abandoned are not this pool's frees
+    collect(s);
+    s->pool.store(this, std::memory_order_relaxed);
+    s->next_abandoned = nullptr;
 
-    return _next_pool->alloc();
+    _stats.no_slabs_adopted += 1;
+
+    return s;
 }
 
-void MemPool::free(void* p) noexcept
+// Keep one empty slab to go on with, and release the others.
+void MemPool::release_empty_slabs() noexcept
 {
-    if (p >= _pool && p < _pool + _block_size * _no_blocks) {
-        if (_next_free_block) {
-            *reinterpret_cast<std::uint8_t**>(p) = _next_free_block;
-            _next_free_block = static_cast<std::uint8_t*>(p);
-        } else {
-            *reinterpret_cast<std::uint8_t**>(p) = _pool + _no_blocks;
-            _next_free_block = static_cast<std::uint8_t*>(p);
+    bool kept = false;
+
+    for (Slab** q = &_partial; *q;) {
+        Slab* s = *q;
+
+        if (s->no_used != 0 || !kept) {
+            kept = kept || s->no_used == 0;
+            q = &s->next_partial;
+            continue;
         }
-        _no_free_blocks += 1;
-    } else {
-        _next_pool->free(p);
+
+        *q = s->next_partial;
+
+        if (s->prev)
+            s->prev->next = s->next;
+        else
+            _slabs = s->next;
+        if (s->next)
+            s->next->prev = s->prev;
+
+        release_slab(s);
     }
+
+    _no_empty = kept ? 1 : 0;
+}
+
+void MemPool::release_slab(Slab* s) noexcept
+{
+    _stats.no_slabs -= 1;
+    _stats.no_blocks -= _no_blocks;
+    _stats.no_slabs_released += 1;
+
+    s->~Slab();
+    ::operator delete(s, std::align_val_t(SLAB_SIZE));
+}
+
+MemPool::Statistics MemPool::statistics() const
+{
+    Statistics stats = _stats;
+
+    stats.no_used_blocks = 0;
+    for (const Slab* s = _slabs; s; s = s->next)
+        stats.no_used_blocks += s->no_used;
+
+    return stats;
 }
@@ -284,6 +284,10 @@ bool InternalEquals(const LispEnvironment& aEnvironment,
     if (!aExpression1.ptr() || !aExpression2.ptr())
         return false;
 
+    std::int64_t a, b;
+    if (aExpression1->SmallInt(a) && aExpression2->SmallInt(b))
+        return a == b;
+
     /*TODO This code would be better, if BigNumber::Equals works*/
 
     BigNumber* n1 = aExpression1->Number(aEnvironment.Precision());
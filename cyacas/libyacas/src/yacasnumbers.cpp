@@ -9,111 +9,598 @@
 #include "yacas/standard.h"
 
 #include <algorithm>
+#include <climits>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <mutex>
 #include <sstream>
 
 namespace {
-    static LispObject*
-    FloatToString(ANumber& aInt, LispEnvironment& aEnvironment, int aBase = 10)
-    {
-        std::string result;
-        ANumberToString(result, aInt, aBase);
-        return LispAtom::New(aEnvironment, result);
-    }
-
-    static int CalculatePrecision(const std::string& str,
-                                  int aBasePrecision,
-                                  int aBase,
-                                  bool& aIsFloat)
-    {
-        const char* aString = str.c_str();
-        const char* ptr = aString;
-        while (*ptr) {
-            switch (*ptr) {
-            case '.':
-                goto FOUND_FLOAT_INDICATOR;
-            case 'e':
-            case 'E':
-            case '@':
-                if (aBase <= 10)
-                    goto FOUND_FLOAT_INDICATOR;
+    // A number literal taken apart in a single pass: the mantissa digits
+    // before and after the point, the power of the base they are to be
+    // multiplied by, and the number of significant digits
+    struct Literal {
+        bool is_float = false;
+        bool negative = false;
+        std::string_view int_digits;
+        std::string_view frac_digits;
+        long exponent = 0;
+        int significant = 0;
+    };
+
+    // A literal is a float if it has a point, or an exponent marker in base
+    // 10 or less. The significant digits of a float run from the first
+    // nonzero digit to the exponent; trailing zeros count. A float zero
+    // such as 0.000 has as many as it has characters from the point on.
+    Literal ScanLiteral(const std::string& str, int aBase)
+    {
+        Literal l;
+
+        const std::string_view s(str);
+        std::size_t i = 0;
+
+        if (i < s.size() && s[i] == '-') {
+            l.negative = true;
+            i += 1;
+        }
+
+        const std::size_t begin = i;
+        std::size_t point = std::string_view::npos;
+        std::size_t end = s.size();
+
+        bool leading = true;
+        int digits = 0;
+        int tail = 0;
+
+        for (; i < s.size(); ++i) {
+            const char c = s[i];
+
+            if (aBase <= 10 && (c == 'e' || c == 'E' || c == '@')) {
+                l.is_float = true;
+                l.exponent = std::strtol(str.c_str() + i + 1, nullptr, 10);
+                end = i;
                 break;
             }
-            ptr++;
-        }
-    FOUND_FLOAT_INDICATOR:
-        // decide whether the string is an integer or a float
-        if (*ptr) {
-            // converting to a float
-            // estimate the number of bits we need to have
-            // find the first significant digit:
-            // initial zeros are not significant
-            ptr = aString;
-            while (*ptr == '.' || *ptr == '-' || *ptr == '0')
-                ptr++;
-            int digit1 = ptr - aString;
-            // find the number of significant base digits (sig_digits)
-            // trailing zeros and . *are* significant, do not include them in
-            // the sets
-            int sig_digits; // = strcspn(aString+digit1, (aBase<=10) ? "-eE@" :
-                            // "-@");
-
-            while (*ptr) {
-                switch (*ptr) {
-                case '@':
-                case '-':
-                    goto FND_1;
-                case 'e':
-                case 'E':
-                    if (aBase <= 10)
-                        goto FND_1;
-                }
-                ptr++;
+
+            if (c == '@' && point != std::string_view::npos) {
+                l.exponent = std::strtol(str.c_str() + i + 1, nullptr, 10);
+                end = i;
+                break;
             }
-        FND_1:
-            sig_digits = ptr - (aString + digit1);
-
-            if (sig_digits <= 0) { // this is when we have "0." in various forms
-                // the number of digits is the number of trailing 0s after .
-
-                // the string cannot consist of only 0 and -, it must contain at
-                // least one of ".eE@" for example, -0000000.000e10 has 4
-                // significant digits counting . as one of the digits, so that
-                // "0" will have 1 digit
-                ptr = aString;
-                while (*ptr == '-' || *ptr == '0')
-                    ptr++;
-                sig_digits = ptr - aString;
-
-                while (*ptr) {
-                    switch (*ptr) {
-                    case 'e':
-                    case 'E':
-                    case '@':
-                        goto FND_2;
-                    }
-                    ptr++;
-                }
-            FND_2:
-                sig_digits = ptr - (aString + sig_digits);
-            } else { // our number is nonzero
-                ptr = aString + digit1;
-                while (*ptr && *ptr != '.')
-                    ptr++;
-                if (*ptr == '.')
-                    --sig_digits; // this is when we have "1.000001" where "."
-                                  // is not a digit, so need to decrement
+
+            if (c == '.') {
+                l.is_float = true;
+                point = i;
+            } else if (c != '0' || !leading) {
+                digits += 1;
             }
-            // ok, so we need to represent MAX(aPrecision,sig_digits) digits in
-            // base aBase
-            aIsFloat = true;
-            return (int)digits_to_bits(std::max(aBasePrecision, sig_digits),
-                                       aBase);
+
+            if (c != '0' && c != '.')
+                leading = false;
+
+            if (point != std::string_view::npos || !leading)
+                tail += 1;
+        }
+
+        if (point == std::string_view::npos) {
+            l.int_digits = s.substr(begin, end - begin);
         } else {
-            aIsFloat = false;
+            l.int_digits = s.substr(begin, point - begin);
+            l.frac_digits = s.substr(point + 1, end - point - 1);
+        }
+
+        l.significant = digits > 0 ? digits : tail;
+
+        return l;
+    }
+
+    // Floats carry this many bits beyond their precision, so that the
+    // rounding errors of a chain of operations stay clear of the digits
+    // shown.
+    constexpr long GUARD_BITS = 64;
+
+    constexpr int LIMB_BITS = sizeof(mp::NN::Limb) * CHAR_BIT;
+
+    // |m| 2^e < 2^msb(m, e), and not less than 2^(msb(m, e) - 1) unless
+    // m = 0
+    long msb(const mp::ZZ& m, long e)
+    {
+        return static_cast<long>(m.no_bits()) + e;
+    }
+
+    // m 2^e with the bits below 2^lsb cut off, rounding to nearest if
+    // round is set and towards zero otherwise
+    void cut_at(mp::ZZ& m, long& e, long lsb, bool round)
+    {
+        if (e >= lsb)
+            return;
+
+        const unsigned long s = lsb - e;
+        const bool neg = m.is_negative();
+        const bool up = round && s <= m.no_bits() && m.test(s - 1);
+
+        if (s >= m.no_bits())
+            m.clear();
+        else
+            m >>= static_cast<unsigned>(s);
+
+        e = lsb;
+
+        if (up) {
+            if (neg)
+                m -= 1;
+            else
+                m += 1;
+        }
+    }
+
+    // m 2^e rounded to nearest at n significant bits
+    void round_to(mp::ZZ& m, long& e, long n)
+    {
+        cut_at(m, e, msb(m, e) - n, true);
+    }
+
+    // b^k as m 2^e, exact as long as it fits into n bits and with a
+    // relative error of about k 2^-n otherwise
+    void power(unsigned b, unsigned long k, long n, mp::ZZ& m, long& e)
+    {
+        m = mp::ZZ(1);
+        e = 0;
+
+        mp::ZZ x(static_cast<int>(b));
+        long xe = 0;
+
+        for (;;) {
+            if (k & 1) {
+                m *= x;
+                e += xe;
+                round_to(m, e, n);
+            }
+
+            k >>= 1;
+            if (!k)
+                break;
+
+            x.sqr();
+            xe *= 2;
+            round_to(x, xe, n);
+        }
+    }
+
+    // bits i to i + 63 of |m|, those below bit 0 read as zeros
+    std::uint64_t bits_from(const mp::ZZ& m, long i)
+    {
+        const mp::NN::Limbs& l = m.magnitude().raw_limbs();
+
+        // the 32 bits from bit 32 j up
+        auto piece = [&l](long j) -> std::uint64_t {
+            constexpr long k = LIMB_BITS / 32;
+            if (j < 0 || j / k >= static_cast<long>(l.size()))
+                return 0;
+            return static_cast<std::uint32_t>(l[j / k] >> (32 * (j % k)));
+        };
+
+        const long j = i >= 0 ? i / 32 : -((31 - i) / 32);
+        const int b = static_cast<int>(i - 32 * j);
+
+        const std::uint64_t r = piece(j) | piece(j + 1) << 32;
+        return b ? r >> b | piece(j + 2) << (64 - b) : r;
+    }
+
+    // the leading bits of |m| as a double t, with |m| = t 2^s
+    double leading(const mp::ZZ& m, long& s)
+    {
+        s = static_cast<long>(m.no_bits()) - 64;
+        return static_cast<double>(bits_from(m, s));
+    }
+
+    double to_double(const mp::ZZ& m, long e)
+    {
+        long s;
+        const double t = leading(m, s);
+
+        // beyond the range of double either way, and safe to pass as int
+        const long x = std::max(-100000L, std::min(100000L, e + s));
+
+        // saturating at the largest double, as reading the decimal string
+        // does, rather than overflowing to infinity
+        const double d =
+            std::min(std::ldexp(t, x), std::numeric_limits<double>::max());
+
+        return m.is_negative() ? -d : d;
+    }
+
+    // sign of m 2^me - n 2^ne
+    int compare(const mp::ZZ& m, long me, const mp::ZZ& n, long ne)
+    {
+        const int sm = m.is_negative() ? -1 : !m.is_zero();
+        const int sn = n.is_negative() ? -1 : !n.is_zero();
+
+        if (sm != sn)
+            return sm < sn ? -1 : 1;
+
+        if (sm == 0)
+            return 0;
+
+        const long bm = msb(m, me);
+        const long bn = msb(n, ne);
+
+        if (bm != bn)
+            return bm < bn ? -sm : sm;
+
+        // the leading bits line up, so the shift is short
+        mp::ZZ a(m);
+        mp::ZZ b(n);
+        a.abs();
+        b.abs();
+
+        if (me > ne)
+            a <<= static_cast<unsigned>(me - ne);
+        else
+            b <<= static_cast<unsigned>(ne - me);
+
+        if (a == b)
             return 0;
+
+        return a < b ? -sm : sm;
+    }
+
+    // m 2^me + n 2^ne as r 2^re, exact but for the bits of m and n below
+    // 2^lsb, which are cut off
+    void add(mp::ZZ m,
+             long me,
+             mp::ZZ n,
+             long ne,
+             long lsb,
+             mp::ZZ& r,
+             long& re)
+    {
+        cut_at(m, me, lsb, false);
+        cut_at(n, ne, lsb, false);
+
+        if (n.is_zero()) {
+            r = std::move(m);
+            re = me;
+            return;
+        }
+
+        if (m.is_zero()) {
+            r = std::move(n);
+            re = ne;
+            return;
+        }
+
+        re = std::min(me, ne);
+        m <<= static_cast<unsigned>(me - re);
+        n <<= static_cast<unsigned>(ne - re);
+        m += n;
+        r = std::move(m);
+    }
+
+    // round(|m| 2^e b^t), computing b^t to at least n bits
+    mp::ZZ scale_round(const mp::ZZ& m, long e, unsigned b, long t, long n)
+    {
+        mp::ZZ p;
+        long pe;
+        power(b, t < 0 ? -t : t, n, p, pe);
+
+        mp::ZZ num(m);
+        num.abs();
+        mp::ZZ den(1);
+
+        if (t >= 0) {
+            num *= p;
+            e += pe;
+        } else {
+            den = std::move(p);
+            e -= pe;
+        }
+
+        if (e >= 0)
+            num <<= static_cast<unsigned>(e);
+        else
+            den <<= static_cast<unsigned>(-e);
+
+        // (2 num + den) / (2 den)
+        num <<= 1;
+        num += den;
+        den <<= 1;
+        num /= den;
+
+        return num;
+    }
+
+    unsigned long bit_length(unsigned long n)
+    {
+        unsigned long l = 0;
+        while (n) {
+            n >>= 1;
+            l += 1;
+        }
+        return l;
+    }
+
+    // above this many bits, a quotient is the dividend times the divisor's
+    // reciprocal, found by Newton's iteration
+    constexpr long DIVIDE_NEWTON_BITS = 4000;
+
+    // and a square root is found the same way, from the reciprocal
+    constexpr long SQRT_NEWTON_BITS = 2000;
+
+    // about 2^(2 p) / d for 2^(p - 1) <= d < 2^p, to within a few units,
+    // by y <- y + y (2^(2 p) - d y) / 2^(2 p) from the value at half the
+    // precision; only the leading bits of the correction are needed, so
+    // neither product is of full size
+    mp::ZZ reciprocal(const mp::ZZ& d, long p)
+    {
+        if (p <= 2 * LIMB_BITS) {
+            mp::ZZ y(1);
+            y <<= static_cast<unsigned>(2 * p);
+            y /= d;
+            return y;
+        }
+
+        const long h = p / 2 + 8;
+
+        mp::ZZ y(d);
+        y >>= static_cast<unsigned>(p - h);
+        y = reciprocal(y, h);
+
+        // 2^(2 p) - d y 2^(p - h) = f 2^(p - h)
+        mp::ZZ f(1);
+        f <<= static_cast<unsigned>(p + h);
+        f.submul(d, y);
+        f >>= static_cast<unsigned>(p - h);
+        f *= y;
+        f >>= static_cast<unsigned>(3 * h - p);
+
+        y <<= static_cast<unsigned>(p - h);
+        y += f;
+
+        return y;
+    }
+
+    // m 2^me / n 2^ne as r 2^re, truncated to at least n bits; past
+    // DIVIDE_NEWTON_BITS, good to a few units in the last of bits + 16 bits
+    void divide(const mp::ZZ& m,
+                long me,
+                const mp::ZZ& n,
+                long ne,
+                long bits,
+                mp::ZZ& r,
+                long& re)
+    {
+        if (bits >= DIVIDE_NEWTON_BITS && !m.is_zero()) {
+            const long p = bits + 16;
+            const long h = p / 2 + 8;
+
+            // |n| = d 2^(k - p) and |m| = a 2^s, to p bits
+            mp::ZZ d(n);
+            d.abs();
+            const long k = static_cast<long>(d.no_bits());
+            if (k > p)
+                d >>= static_cast<unsigned>(k - p);
+            else
+                d <<= static_cast<unsigned>(p - k);
+
+            mp::ZZ a(m);
+            a.abs();
+            const long s = static_cast<long>(a.no_bits()) - p;
+            if (s > 0)
+                a >>= static_cast<unsigned>(s);
+            else
+                a <<= static_cast<unsigned>(-s);
+
+            // a 2^p / d from the reciprocal of d to h bits (Karp and
+            // Markstein): the quotient q to h bits, then the remainder
+            // a 2^h - q d to h bits times the reciprocal
+            mp::ZZ y(d);
+            y >>= static_cast<unsigned>(p - h);
+            y = reciprocal(y, h);
+
+            mp::ZZ q(a);
+            q >>= static_cast<unsigned>(p - h);
+            q *= y;
+            q >>= static_cast<unsigned>(h);
+
+            mp::ZZ t(a);
+            t <<= static_cast<unsigned>(h);
+            t.submul(q, d);
+            t >>= static_cast<unsigned>(p - h);
+            t *= y;
+            t >>= static_cast<unsigned>(3 * h - p);
+
+            q <<= static_cast<unsigned>(p - h);
+            q += t;
+
+            if (m.is_negative() != n.is_negative())
+                q.neg();
+
+            r = std::move(q);
+            re = me - ne + s - k;
+            return;
+        }
+
+        const long s = std::max(
+            0L,
+            bits + 1 + static_cast<long>(n.no_bits()) -
+                static_cast<long>(m.no_bits()));
+
+        r = m;
+        r <<= static_cast<unsigned>(s);
+        r /= n;
+        re = me - ne - s;
+    }
+
+    // about Sqrt(a) for 2^(2 p - 2) <= a < 2^(2 p), to within a few units,
+    // by s <- s + (a - s^2) / (2 s) from the root at half the precision,
+    // the division done by the reciprocal of that root
+    mp::ZZ sqrt_fixed(const mp::ZZ& a, long p)
+    {
+        if (p <= SQRT_NEWTON_BITS) {
+            mp::NN s(a.to_NN());
+            s.isqrt();
+            return mp::ZZ(s);
+        }
+
+        const long h = p / 2 + 8;
+
+        mp::ZZ s(a);
+        s >>= static_cast<unsigned>(2 * (p - h));
+        s = sqrt_fixed(s, h);
+
+        // a - s^2 2^(2 (p - h)), of about 2 p - h bits
+        mp::ZZ r(s);
+        r.sqr();
+        r <<= static_cast<unsigned>(2 * (p - h));
+        r.neg();
+        r += a;
+
+        r >>= static_cast<unsigned>(2 * (p - h));
+        r *= reciprocal(s, h);
+        r >>= static_cast<unsigned>(3 * h - p + 1);
+
+        s <<= static_cast<unsigned>(p - h);
+        s += r;
+
+        return s;
+    }
+
+    // d b^k as m 2^e, rounded to n bits
+    void scale(const mp::ZZ& d, unsigned b, long k, long n, mp::ZZ& m, long& e)
+    {
+        if (k == 0 || d.is_zero()) {
+            m = d;
+            e = 0;
+            round_to(m, e, n);
+            return;
+        }
+
+        const unsigned long a = k < 0 ? -k : k;
+
+        mp::ZZ p;
+        long pe;
+        power(b, a, n + bit_length(a) + 2, p, pe);
+
+        if (k > 0) {
+            m = d;
+            m *= p;
+            e = pe;
+        } else {
+            divide(d, 0, p, pe, n, m, e);
+        }
+
+        round_to(m, e, n);
+    }
+
+    // h 2^64 + l, its 32-bit pieces shifted and or-ed in from the top,
+    // which takes at most one allocation where adding them would make
+    // room for a carry each time
+    mp::ZZ to_zz(std::uint64_t h, std::uint64_t l)
+    {
+        mp::ZZ m;
+
+        for (std::uint64_t w : {h >> 32, h & 0xffffffff, l >> 32, l & 0xffffffff}) {
+            if (!m.is_zero())
+                m <<= 32;
+            m |= mp::ZZ(mp::NN(static_cast<mp::NN::Limb>(w)));
+        }
+
+        return m;
+    }
+
+    mp::ZZ to_zz(std::int64_t n)
+    {
+        mp::ZZ z = to_zz(0, n < 0 ? -static_cast<std::uint64_t>(n) : n);
+        if (n < 0)
+            z.neg();
+
+        return z;
+    }
+
+    // whether m 2^e has no fractional bits
+    bool is_integral(const mp::ZZ& m, long e)
+    {
+        if (e >= 0 || m.is_zero())
+            return true;
+
+        const unsigned long s = -e;
+        if (s >= m.no_bits())
+            return false;
+
+        for (unsigned long i = 0; i < s; ++i)
+            if (m.test(i))
+                return false;
+
+        return true;
+    }
+
+    // Values that rounding errors put just below an integer should floor
+    // to it, as the decimal representation shown would suggest, so the
+    // lower half of the guard bits is rounded off first; but never above
+    // the first fractional bit. Results of the double and double-double
+    // paths carry fewer guard bits, and lose half of those they have.
+    void round_guard(mp::ZZ& m, long& e, int aPrecision)
+    {
+        const long spare = std::max(
+            0L,
+            std::min(GUARD_BITS, static_cast<long>(m.no_bits()) - aPrecision));
+
+        cut_at(m, e, std::min(msb(m, e) - aPrecision - spare / 2, -1L), true);
+    }
+
+    // n rounded to the nearest multiple of 10^k
+    void round_decimal(mp::ZZ& n, unsigned long k)
+    {
+        mp::ZZ t(10);
+        t.pow(static_cast<unsigned>(k));
+
+        const bool negative = n.is_negative();
+        n.abs();
+
+        mp::ZZ r(n);
+        r %= t;
+        n -= r;
+        r <<= 1;
+        if (r >= t)
+            n += t;
+
+        if (negative)
+            n.neg();
+    }
+
+    // m 2^e as an integer, rounded towards zero or, if floor is set,
+    // towards minus infinity. Digits past those the precision and the
+    // guard bits determine are zeros, as in the decimal representation
+    // shown, rather than the noise of the binary one.
+    mp::ZZ to_integer(mp::ZZ m, long e, int aPrecision, bool floor)
+    {
+        const long bits = aPrecision + GUARD_BITS;
+        const bool beyond = aPrecision > 0 && msb(m, e) > bits;
+
+        round_guard(m, e, aPrecision);
+
+        if (e >= 0) {
+            m <<= static_cast<unsigned>(e);
+        } else {
+            const bool down = floor && m.is_negative() && !is_integral(m, e);
+
+            cut_at(m, e, 0, false);
+
+            if (down)
+                m -= 1;
+        }
+
+        if (beyond) {
+            const unsigned long n = m.no_digits();
+            const unsigned long d = bits_to_digits(bits, 10) - 1;
+            if (n > d)
+                round_decimal(m, n - d);
         }
+
+        return m;
     }
 }
 
@@ -132,68 +619,156 @@ GcdInteger(LispObject* int1, LispObject* int2, LispEnvironment& aEnvironment)
     BigNumber a(*i1);
     BigNumber b(*i2);
 
-    if (!a.IsInt() && a.iNumber->iExp != 0)
+    if (!a.IsIntegral())
         throw LispErrNotInteger();
 
-    if (!b.IsInt() && b.iNumber->iExp != 0)
+    if (!b.IsIntegral())
         throw LispErrNotInteger();
 
     a.BecomeInt();
     b.BecomeInt();
 
-    BigNumber* res = new BigNumber(mp::gcd(*i1->_zz, *i2->_zz));
+    BigNumber* res = new BigNumber(mp::gcd(*a._zz, *b._zz));
     return new LispNumber(res);
 }
 
-LispObject* PowerFloat(LispObject* int1,
-                       LispObject* int2,
-                       LispEnvironment& aEnvironment,
-                       int aPrecision)
+LispObject* ExtendedGcdInteger(LispObject* int1,
+                               LispObject* int2,
+                               LispEnvironment& aEnvironment)
 {
-    if (int2->Number(aPrecision)->iNumber->iExp != 0)
+    BigNumber a(*int1->Number(0));
+    BigNumber b(*int2->Number(0));
+
+    if (!a.IsIntegral())
         throw LispErrNotInteger();
 
-    // Raising to the power of an integer can be done fastest by squaring
-    // and bitshifting: x^(a+b) = x^a*x^b . Then, regarding each bit
-    // in y (seen as a binary number) as added, the algorithm becomes:
-    //
-    ANumber x(*int1->Number(aPrecision)->iNumber);
-    ANumber y(*int2->Number(aPrecision)->iNumber);
-    const bool neg = y.iNegative;
-    y.iNegative = false;
+    if (!b.IsIntegral())
+        throw LispErrNotInteger();
 
-    // result <- 1
-    ANumber result("1", aPrecision);
-    // base <- x
-    ANumber base(aPrecision);
-    base.CopyFrom(x);
+    a.BecomeInt();
+    b.BecomeInt();
 
-    ANumber copy(aPrecision);
+    mp::ZZ s, t;
+    const mp::ZZ g = mp::xgcd(*a._zz, *b._zz, s, t);
 
-    // while (y!=0)
-    while (!y.IsZero()) {
-        // if (y&1 != 0)
-        if ((y[0] & 1) != 0) {
-            // result <- result*base
-            copy.CopyFrom(result);
-            Multiply(result, copy, base);
-        }
-        // base <- base*base
-        copy.CopyFrom(base);
-        Multiply(base, copy, copy);
-        // y <- y>>1
-        BaseShiftRight(y, 1);
-    }
+    return LispSubList::New(
+        LispObjectAdder(aEnvironment.iList->Copy()) +
+        LispObjectAdder(new LispNumber(new BigNumber(g))) +
+        LispObjectAdder(new LispNumber(new BigNumber(s))) +
+        LispObjectAdder(new LispNumber(new BigNumber(t))));
+}
 
-    if (neg) {
-        ANumber one("1", aPrecision);
-        ANumber dummy(10);
-        copy.CopyFrom(result);
-        Divide(result, dummy, one, copy);
-    }
+LispObject* PowerModInteger(LispObject* int1,
+                           LispObject* int2,
+                           LispObject* int3,
+                           LispEnvironment& aEnvironment)
+{
+    BigNumber b(*int1->Number(0));
+    BigNumber e(*int2->Number(0));
+    BigNumber m(*int3->Number(0));
+
+    if (!b.IsIntegral())
+        throw LispErrNotInteger();
+
+    if (!e.IsIntegral())
+        throw LispErrNotInteger();
+
+    if (!m.IsIntegral())
+        throw LispErrNotInteger();
+
+    b.BecomeInt();
+    e.BecomeInt();
+    m.BecomeInt();
+
+    if (e._zz->is_negative() || m._zz->is_negative() || m._zz->is_zero())
+        throw LispErrInvalidArg();
+
+    BigNumber* res = new BigNumber(mp::powmod(*b._zz, *e._zz, *m._zz));
+    return new LispNumber(res);
+}
+
+LispObject* IntSqrtInteger(LispObject* int1, LispEnvironment& aEnvironment)
+{
+    BigNumber n(*int1->Number(0));
+
+    if (!n.IsIntegral())
+        throw LispErrNotInteger();
+
+    n.BecomeInt();
+
+    if (n._zz->is_negative())
+        throw LispErrInvalidArg();
+
+    mp::NN r(n._zz->to_NN());
+    r.isqrt();
+
+    return new LispNumber(new BigNumber(mp::ZZ(r)));
+}
+
+LispObject* IntNthRootInteger(LispObject* int1,
+                              LispObject* int2,
+                              LispEnvironment& aEnvironment)
+{
+    BigNumber n(*int1->Number(0));
+    BigNumber k(*int2->Number(0));
+
+    if (!n.IsIntegral())
+        throw LispErrNotInteger();
+
+    if (!k.IsIntegral())
+        throw LispErrNotInteger();
+
+    n.BecomeInt();
+    k.BecomeInt();
+
+    if (n._zz->is_negative() || k._zz->is_negative() || k._zz->is_zero())
+        throw LispErrInvalidArg();
+
+    mp::NN r(n._zz->to_NN());
+
+    // the root of anything but 0 is 1 once k exceeds its number of bits
+    if (k._zz->no_bits() > 31)
+        r = r.is_zero() ? mp::NN() : mp::NN::ONE;
+    else
+        r.iroot(k._zz->to_int());
+
+    return new LispNumber(new BigNumber(mp::ZZ(r)));
+}
+
+LispObject* PerfectPowerInteger(LispObject* int1, LispEnvironment& aEnvironment)
+{
+    BigNumber n(*int1->Number(0));
 
-    // result
-    return FloatToString(result, aEnvironment);
+    if (!n.IsIntegral())
+        throw LispErrNotInteger();
+
+    n.BecomeInt();
+
+    if (n._zz->is_negative())
+        throw LispErrInvalidArg();
+
+    mp::NN r;
+    unsigned k;
+    n._zz->to_NN().is_perfect_power(r, k);
+
+    return LispSubList::New(
+        LispObjectAdder(aEnvironment.iList->Copy()) +
+        LispObjectAdder(new LispNumber(new BigNumber(mp::ZZ(r)))) +
+        LispObjectAdder(new LispNumber(new BigNumber(mp::ZZ(static_cast<int>(k))))));
+}
+
+// the shift count of ShiftLeft and ShiftRight
+static int ShiftCount(LispObject* aCount)
+{
+    const BigNumber& n = *aCount->Number(0);
+
+    if (!n.IsInt())
+        throw LispErrNotInteger();
+
+    if (n.Sign() < 0 || n.BitCount() > 31)
+        throw LispErrInvalidArg();
+
+    return static_cast<int>(n.Double());
 }
 
 LispObject* ShiftLeft(LispObject* int1,
@@ -201,9 +776,8 @@ LispObject* ShiftLeft(LispObject* int1,
                       LispEnvironment& aEnvironment,
                       int aPrecision)
 {
-    BigNumber* number = new BigNumber("0", aEnvironment.BinaryPrecision());
-    int bits = InternalAsciiToInt(*int2->String());
-    number->ShiftLeft(*int1->Number(aPrecision), bits);
+    BigNumber* number = new BigNumber(*int1->Number(aPrecision));
+    number->ShiftLeft(*number, ShiftCount(int2));
     return new LispNumber(number);
 }
 
@@ -212,86 +786,170 @@ LispObject* ShiftRight(LispObject* int1,
                        LispEnvironment& aEnvironment,
                        int aPrecision)
 {
-    BigNumber* number = new BigNumber("0", aEnvironment.BinaryPrecision());
-    int bits = InternalAsciiToInt(*int2->String());
-    number->ShiftRight(*int1->Number(aPrecision), bits);
+    BigNumber* number = new BigNumber(*int1->Number(aPrecision));
+    number->ShiftRight(*number, ShiftCount(int2));
     return new LispNumber(number);
 }
 
-static void DivideInteger(ANumber& aQuotient,
-                          ANumber& aRemainder,
-                          const char* int1,
-                          const char* int2,
-                          int aPrecision)
+// The remainder takes the sign of int1 times that of int2, as it always has.
+LispObject* ModFloat(LispObject* int1,
+                     LispObject* int2,
+                     LispEnvironment& aEnvironment,
+                     int aPrecision)
 {
-    ANumber a1(int1, aPrecision);
-    ANumber a2(int2, aPrecision);
+    BigNumber x(*int1->Number(aPrecision));
+    BigNumber y(*int2->Number(aPrecision));
 
-    if (a1.iExp != 0 || a2.iExp != 0)
+    if (!x.IsIntegral() || !y.IsIntegral())
         throw LispErrNotInteger();
 
-    if (a2.IsZero())
+    x.BecomeInt();
+    y.BecomeInt();
+
+    if (y._zz->is_zero())
         throw LispErrInvalidArg();
 
-    IntegerDivide(aQuotient, aRemainder, a1, a2);
-}
+    *x._zz %= *y._zz;
 
-LispObject* ModFloat(LispObject* int1,
-                     LispObject* int2,
-                     LispEnvironment& aEnvironment,
-                     int aPrecision)
-{
-    ANumber quotient(static_cast<int>(0));
-    ANumber remainder(static_cast<int>(0));
-    DivideInteger(quotient,
-                  remainder,
-                  int1->String()->c_str(),
-                  int2->String()->c_str(),
-                  aPrecision);
-    return FloatToString(remainder, aEnvironment, 10);
+    return new LispNumber(new BigNumber(x));
 }
 
 LispObject*
 LispFactorial(LispObject* int1, LispEnvironment& aEnvironment, int aPrecision)
 {
-    int nr = InternalAsciiToInt(*int1->String());
+    BigNumber n(*int1->Number(0));
 
-    if (nr < 0)
-        throw LispErrInvalidArg();
+    if (!n.IsIntegral())
+        throw LispErrNotInteger();
+
+    n.BecomeInt();
 
-    ANumber fac("1", aPrecision);
-    int i;
-    for (i = 2; i <= nr; i++)
-        BaseTimesInt(fac, i, WordBase);
+    if (n._zz->is_negative() || n._zz->no_bits() > 31)
+        throw LispErrInvalidArg();
 
-    return FloatToString(fac, aEnvironment);
+    BigNumber* res = new BigNumber(mp::ZZ(mp::factorial(n._zz->to_int())));
+    return new LispNumber(res);
 }
 
-BigNumber::BigNumber(const std::string& aString, int aBasePrecision, int aBase)
+LispObject* DoubleFactorialInteger(LispObject* int1,
+                                   LispEnvironment& aEnvironment)
 {
-    bool isFloat = false;
+    BigNumber n(*int1->Number(0));
 
-    const int digits = aBasePrecision;
-    iPrecision = CalculatePrecision(aString, aBasePrecision, aBase, isFloat);
+    if (!n.IsIntegral())
+        throw LispErrNotInteger();
+
+    n.BecomeInt();
+
+    if (n._zz->is_negative() || n._zz->no_bits() > 31)
+        throw LispErrInvalidArg();
+
+    BigNumber* res =
+        new BigNumber(mp::ZZ(mp::double_factorial(n._zz->to_int())));
+    return new LispNumber(res);
+}
+
+LispObject* BinomialInteger(LispObject* int1,
+                            LispObject* int2,
+                            LispEnvironment& aEnvironment)
+{
+    BigNumber n(*int1->Number(0));
+    BigNumber k(*int2->Number(0));
+
+    if (!n.IsIntegral())
+        throw LispErrNotInteger();
+
+    if (!k.IsIntegral())
+        throw LispErrNotInteger();
+
+    n.BecomeInt();
+    k.BecomeInt();
+
+    if (n._zz->is_negative() || k._zz->is_negative() || *k._zz > *n._zz)
+        return new LispNumber(new BigNumber(mp::ZZ(0)));
+
+    mp::ZZ l(*n._zz);
+    l -= *k._zz;
+    const mp::ZZ& m = std::min(*k._zz, l);
+
+    if (m.no_bits() > 31)
+        throw LispErrInvalidArg();
+
+    BigNumber* res =
+        new BigNumber(mp::ZZ(mp::binomial(n._zz->to_NN(), m.to_int())));
+    return new LispNumber(res);
+}
+
+LispObject* PartialFactorialInteger(LispObject* int1,
+                                    LispObject* int2,
+                                    LispEnvironment& aEnvironment)
+{
+    BigNumber a(*int1->Number(0));
+    BigNumber b(*int2->Number(0));
+
+    if (!a.IsIntegral())
+        throw LispErrNotInteger();
+
+    if (!b.IsIntegral())
+        throw LispErrNotInteger();
+
+    a.BecomeInt();
+    b.BecomeInt();
+
+    mp::ZZ n(*b._zz);
+    n -= *a._zz;
+
+    if (n.no_bits() > 31)
+        throw LispErrInvalidArg();
+
+    BigNumber* res = new BigNumber(mp::partial_factorial(*a._zz, *b._zz));
+    return new LispNumber(res);
+}
 
-    iNumber.reset(new ANumber(aString, digits, aBase));
+BigNumber::BigNumber(const std::string& aString, int aBasePrecision, int aBase) :
+    _exp(0)
+{
+    const Literal l = ScanLiteral(aString, aBase);
 
-    if (!isFloat && iNumber->iExp == 0 && iNumber->iTensExp == 0) {
-        _zz.reset(new mp::ZZ(aString, aBase));
-        iNumber.release();
+    if (!l.is_float) {
+        iPrecision = 0;
+        _zz.emplace(aString, aBase);
+        return;
     }
+
+    // ok, so we need to represent max(aBasePrecision, significant) digits
+    // in base aBase
+    iPrecision = digits_to_bits(std::max(aBasePrecision, l.significant), aBase);
+
+    std::string digits(l.int_digits);
+    digits += l.frac_digits;
+
+    if (digits.empty())
+        digits = "0";
+
+    scale(mp::ZZ(digits, aBase),
+          aBase,
+          l.exponent - static_cast<long>(l.frac_digits.size()),
+          iPrecision + GUARD_BITS,
+          _man,
+          _exp);
+
+    if (l.negative)
+        _man.neg();
 }
 
-BigNumber::BigNumber(const mp::ZZ& zz) : iPrecision(0), _zz(new mp::ZZ(zz)) {}
+BigNumber::BigNumber(const mp::ZZ& zz) : iPrecision(0), _exp(0), _zz(zz) {}
 
-BigNumber::BigNumber(const BigNumber& aOther) :
-    iPrecision(aOther.GetPrecision())
+BigNumber::BigNumber(std::int64_t n) : iPrecision(0), _exp(0), _zz(to_zz(n))
 {
-    if (aOther.iNumber)
-        iNumber.reset(new ANumber(*aOther.iNumber));
+}
 
-    if (aOther._zz)
-        _zz.reset(new mp::ZZ(*aOther._zz));
+BigNumber::BigNumber(const BigNumber& aOther) :
+    iPrecision(aOther.iPrecision),
+    _man(aOther._man),
+    _exp(aOther._exp),
+    _zz(aOther._zz)
+{
 }
 
 BigNumber& BigNumber::operator=(const BigNumber& bn)
@@ -299,30 +957,30 @@ BigNumber& BigNumber::operator=(const BigNumber& bn)
     if (this == &bn)
         return *this;
 
-    iPrecision = bn.GetPrecision();
-
-    if (bn.iNumber) {
-        if (iNumber)
-            iNumber->CopyFrom(*bn.iNumber);
-        else
-            iNumber.reset(new ANumber(*bn.iNumber));
-
-        _zz.reset();
-    }
-
-    if (bn._zz) {
-        if (_zz)
-            *_zz = *bn._zz;
-        else
-            _zz.reset(new mp::ZZ(*bn._zz));
+    iPrecision = bn.iPrecision;
+    _man = bn._man;
+    _exp = bn._exp;
+    _zz = bn._zz;
 
-        iNumber.reset();
-    }
     return *this;
 }
 
-/// Export a number to a string in given base to given base digits
-// FIXME API breach: aPrecision is supposed to be in digits, not bits
+void BigNumber::SetFloat(mp::ZZ aMantissa, long aExponent, int aPrecision)
+{
+    _zz.reset();
+    _man = std::move(aMantissa);
+    _exp = aExponent;
+    iPrecision = aPrecision;
+}
+
+/// Export a number to a string in given base to given base digits. Floats
+/// with an integer part of up to four digits are written out with
+/// aBasePrecision digits after the point, others as 0.ddd times a power of
+/// the base, with aBasePrecision significant digits; trailing zeros are
+/// dropped.
+// The last digit is rounded to nearest, so that the string, which is what
+// a float is read back from at a higher precision, is as close to the
+// value as its digits allow.
 void BigNumber::ToString(std::string& aResult,
                          int aBasePrecision,
                          int aBase) const
@@ -332,556 +990,1710 @@ void BigNumber::ToString(std::string& aResult,
         return;
     }
 
-    ANumber num(*iNumber);
+    if (_man.is_zero()) {
+        aResult = "0";
+        return;
+    }
+
+    const unsigned b = aBase;
+    const long d = std::max(1, aBasePrecision);
+    const long g = bits_to_digits(GUARD_BITS / 2, b);
+
+    mp::ZZ guard(static_cast<int>(b));
+    guard.pow(g);
+
+    mp::ZZ half(guard);
+    half /= mp::ZZ(2);
+
+    // the digits of |x| b^k, rounded, of which there are no more than
+    // d + 4; b^(k + g) is computed with enough bits for the rounding
+    // errors of its powers to stay in the guard digits
+    const long bits = digits_to_bits(d + g + 4, b) + GUARD_BITS;
+
+    auto digits_of = [&](long k) {
+        const long a = std::abs(k + g);
+        mp::ZZ n = scale_round(_man, _exp, b, k + g, bits + bit_length(a));
+        n += half;
+        n /= guard;
+        return n;
+    };
+
+    // b^(E - 1) <= |x| < b^E, estimated first and then corrected by the
+    // number of digits found
+    long s;
+    const double t = leading(_man, s);
+    long E = static_cast<long>(
+                 std::floor((std::log2(t) + s + _exp) / std::log2(b))) +
+             1;
+
+    std::string r;
+
+    // the estimate may be one too low for values that round up to 1
+    if (E >= 0 && E <= 4) {
+        std::string digits = digits_of(d).to_string(b);
+        const long e = static_cast<long>(digits.size()) - d;
+
+        if (e >= 1 && e <= 4) {
+            std::string frac = digits.substr(e);
+            frac.erase(frac.find_last_not_of('0') + 1);
+
+            r = digits.substr(0, e) + "." + frac;
+        }
+    }
+
+    if (r.empty()) {
+        std::string digits = digits_of(d - E).to_string(b);
+
+        for (int i = 0; i < 4 && static_cast<long>(digits.size()) != d; ++i) {
+            E += static_cast<long>(digits.size()) - d;
+            digits = digits_of(d - E).to_string(b);
+        }
+
+        digits.erase(digits.find_last_not_of('0') + 1);
+
+        r = "0." + digits;
+
+        if (E != 0)
+            r += (b > 10 ? "@" : "e") + std::to_string(E);
+    }
+
+    if (_man.is_negative())
+        r.insert(0, "-");
+
+    aResult = std::move(r);
+}
+
+double BigNumber::Double() const
+{
+    if (!IsInt())
+        return to_double(_man, _exp);
+
+    std::istringstream is(_zz->to_string());
+    double d;
+    is >> d;
+    return d;
+}
+
+// Float results are rounded to their precision plus the guard bits. The
+// arguments are rounded to the same number of bits first, so that integers
+// of any size and floats of a higher precision cost no more than that.
+// Products and sums get the precision asked for, quotients that of the
+// arguments if higher.
+void BigNumber::Multiply(const BigNumber& aX,
+                         const BigNumber& aY,
+                         int aPrecision)
+{
+    if (aX.IsInt() && aY.IsInt()) {
+        BecomeInt();
+        *_zz = *aX._zz;
+        *_zz *= *aY._zz;
+
+        return;
+    }
+
+    const int precision = aPrecision;
+    const long bits = precision + GUARD_BITS;
+
+    mp::ZZ x(aX.Mantissa());
+    long xe = aX.Exponent();
+    round_to(x, xe, bits);
+
+    mp::ZZ y(aY.Mantissa());
+    long ye = aY.Exponent();
+    round_to(y, ye, bits);
+
+    x *= y;
+    xe += ye;
+    round_to(x, xe, bits);
+
+    SetFloat(std::move(x), xe, precision);
+}
+
+void BigNumber::Add(const BigNumber& aX, const BigNumber& aY, int aPrecision)
+{
+    if (aX.IsInt() && aY.IsInt()) {
+        BecomeInt();
+        *_zz = *aX._zz;
+        *_zz += *aY._zz;
+        return;
+    }
+
+    const int precision = aPrecision;
+    const long bits = precision + GUARD_BITS;
+
+    const mp::ZZ& x = aX.Mantissa();
+    const long xe = aX.Exponent();
+    const mp::ZZ& y = aY.Mantissa();
+    const long ye = aY.Exponent();
+
+    // bits well below the last one kept in the larger of the two make no
+    // difference to the rounded sum
+    long top;
+    if (x.is_zero())
+        top = msb(y, ye);
+    else if (y.is_zero())
+        top = msb(x, xe);
+    else
+        top = std::max(msb(x, xe), msb(y, ye));
+
+    mp::ZZ r;
+    long re;
+    add(x, xe, y, ye, top - bits - 2, r, re);
+    round_to(r, re, bits);
+
+    SetFloat(std::move(r), re, precision);
+}
+
+void BigNumber::MultiplyAdd(const BigNumber& aX,
+                            const BigNumber& aY,
+                            int aPrecision)
+{
+    if (IsInt() && aX.IsInt() && aY.IsInt()) {
+        _zz->addmul(*aX._zz, *aY._zz);
+        return;
+    }
+
+    BigNumber p(aX);
+    p.Multiply(aX, aY, aPrecision);
+    BigNumber s(*this);
+    Add(s, p, aPrecision);
+}
+
+void BigNumber::Negate(const BigNumber& aX)
+{
+    if (this != &aX)
+        *this = aX;
+
+    if (IsInt())
+        _zz->neg();
+    else
+        _man.neg();
+}
+
+void BigNumber::Divide(const BigNumber& aX, const BigNumber& aY, int aPrecision)
+{
+    if (aX.IsInt() && aY.IsInt()) {
+        if (aY._zz->is_zero())
+            throw LispErrInvalidArg();
+
+        BecomeInt();
+        *_zz = *aX._zz;
+        *_zz /= *aY._zz;
+
+        return;
+    }
+
+    if (aY.Mantissa().is_zero())
+        throw LispErrInvalidArg();
+
+    const int precision = std::max({aPrecision, aX.iPrecision, aY.iPrecision});
+    const long bits = precision + GUARD_BITS;
+
+    mp::ZZ x(aX.Mantissa());
+    long xe = aX.Exponent();
+    round_to(x, xe, bits);
+
+    mp::ZZ y(aY.Mantissa());
+    long ye = aY.Exponent();
+    round_to(y, ye, bits);
+
+    mp::ZZ r;
+    long re;
+    divide(x, xe, y, ye, bits, r, re);
+    round_to(r, re, bits);
+
+    SetFloat(std::move(r), re, precision);
+}
+
+void BigNumber::DivideExact(const BigNumber& aX, const BigNumber& aY)
+{
+    if (!aX.IsIntegral())
+        throw LispErrNotInteger();
+
+    if (!aY.IsIntegral())
+        throw LispErrNotInteger();
+
+    BigNumber x(aX);
+    x.BecomeInt();
+    BigNumber y(aY);
+    y.BecomeInt();
+
+    if (y._zz->is_zero())
+        throw LispErrInvalidArg();
+
+    BecomeInt();
+    *_zz = *x._zz;
+    _zz->divexact(*y._zz);
+}
+
+void BigNumber::ShiftLeft(const BigNumber& aX, int aNrToShift)
+{
+    if (this != &aX)
+        *this = aX;
+
+    BecomeInt();
+
+    *_zz <<= aNrToShift;
+}
+
+void BigNumber::ShiftRight(const BigNumber& aX, int aNrToShift)
+{
+    if (this != &aX)
+        *this = aX;
+
+    BecomeInt();
+
+    *_zz >>= aNrToShift;
+}
+
+void BigNumber::BitAnd(const BigNumber& aX, const BigNumber& aY)
+{
+    BecomeInt();
+
+    BigNumber x(aX);
+    x.BecomeInt();
+    BigNumber y(aY);
+    y.BecomeInt();
+
+    *_zz = *x._zz;
+    *_zz &= *y._zz;
+}
+
+void BigNumber::BitOr(const BigNumber& aX, const BigNumber& aY)
+{
+    BecomeInt();
+
+    BigNumber x(aX);
+    x.BecomeInt();
+    BigNumber y(aY);
+    y.BecomeInt();
+
+    *_zz = *x._zz;
+    *_zz |= *y._zz;
+    _zz->abs();
+}
+
+void BigNumber::BitXor(const BigNumber& aX, const BigNumber& aY)
+{
+    BecomeInt();
+
+    BigNumber x(aX);
+    x.BecomeInt();
+    BigNumber y(aY);
+    y.BecomeInt();
+
+    *_zz = *x._zz;
+    *_zz ^= *y._zz;
+    _zz->abs();
+}
+
+void BigNumber::BitNot(const BigNumber& aX)
+{
+    BecomeInt();
+
+    BigNumber x(aX);
+    x.BecomeInt();
+
+    *_zz = *x._zz;
+    _zz->neg();
+    _zz->abs();
+}
+
+/// Bit count operation: return the number of significant bits if integer,
+/// return the binary exponent if float (shortcut for binary logarithm)
+// give BitCount as platform integer
+signed long BigNumber::BitCount() const
+{
+    if (Mantissa().is_zero())
+        return 0;
+
+    return msb(Mantissa(), Exponent());
+}
+
+int BigNumber::Sign() const
+{
+    const mp::ZZ& m = Mantissa();
+
+    if (m.is_negative())
+        return -1;
+    if (m.is_zero())
+        return 0;
+    return 1;
+}
+
+void BigNumber::DumpDebugInfo(std::ostream& os) const
+{
+    if (IsInt())
+        os << "No number representation\n";
+    else
+        os << "Number: " << _man << " * 2^" << _exp << ", " << iPrecision
+           << " bits\n";
+}
+
+void BigNumber::Floor(const BigNumber& aX)
+{
+    if (aX.IsInt()) {
+        BecomeInt();
+        *_zz = *aX._zz;
+
+        return;
+    }
+
+    iPrecision = aX.iPrecision;
+    _zz.emplace(to_integer(aX._man, aX._exp, aX.iPrecision, true));
+}
+
+void BigNumber::Precision(int aPrecision)
+{
+    if (aPrecision < 0)
+        aPrecision = 0;
+
+    if (!IsInt() && aPrecision < iPrecision)
+        round_to(_man, _exp, aPrecision + GUARD_BITS);
+
+    iPrecision = aPrecision;
+}
+
+// basic object manipulation
+
+// Floats are equal when they differ in no more than the last bit of the
+// higher of the two precisions, relative to the larger of them; a float is
+// equal to zero only if it is zero.
+bool BigNumber::Equals(const BigNumber& aOther) const
+{
+    if (IsInt() && aOther.IsInt())
+        return *_zz == *aOther._zz;
+
+    const mp::ZZ& x = Mantissa();
+    const long xe = Exponent();
+    mp::ZZ y(aOther.Mantissa());
+    const long ye = aOther.Exponent();
+
+    const int precision = std::max(iPrecision, aOther.iPrecision);
+
+    if (precision <= 0)
+        return compare(x, xe, y, ye) == 0;
+
+    if (x.is_zero() || y.is_zero())
+        return x.is_zero() && y.is_zero();
+
+    const long top = std::max(msb(x, xe), msb(y, ye));
+
+    const long t = top - precision;
+
+    y.neg();
+
+    mp::ZZ d;
+    long de;
+    add(x, xe, y, ye, t - 2, d, de);
+
+    return d.is_zero() || msb(d, de) <= t;
+}
+
+bool BigNumber::IsInt() const
+{
+    return !!_zz;
+}
+
+bool BigNumber::IsIntegral() const
+{
+    return IsInt() || is_integral(_man, _exp);
+}
+
+bool BigNumber::IsSmall() const
+{
+    if (IsInt())
+        return _zz->no_bits() <= 53;
+
+    // standard range of double precision is about 53 bits of mantissa and
+    // binary exponent of about 1021
+    return iPrecision <= 53 && std::abs(msb(_man, _exp)) < 1021;
+}
+
+void BigNumber::BecomeInt()
+{
+    if (IsInt())
+        return;
+
+    _zz.emplace(to_integer(_man, _exp, iPrecision, false));
+    _man.clear();
+    _exp = 0;
+}
+
+/// Transform integer to float, setting a given bit precision.
+/// Note that aPrecision=0 means automatic setting (just enough digits to
+/// represent the integer).
+void BigNumber::BecomeFloat(int aPrecision)
+{
+    if (!IsInt())
+        return;
+
+    SetFloat(std::move(*_zz), 0, std::max(iPrecision, aPrecision));
+}
+
+bool BigNumber::LessThan(const BigNumber& aOther) const
+{
+    if (IsInt() && aOther.IsInt())
+        return *_zz < *aOther._zz;
+
+    return compare(Mantissa(), Exponent(), aOther.Mantissa(), aOther.Exponent()) < 0;
+}
+
+// The elementary functions are computed in fixed point, an mp::ZZ a with p
+// fractional bits standing for a 2^-p. Arguments are reduced by multiples
+// of Ln(2) for Exp and of Pi/2 for Sin and Cos, and to a mantissa near 1
+// for Ln; Exp, Sin and Cos of the reduced argument are summed as Taylor
+// series at a further 2^-s of it and brought back by s squarings or
+// doublings, while Ln and ArcTan come from those by Newton's iteration,
+// doubling the precision at each step. The extra fractional bits keep the
+// rounding errors below the guard bits; more are taken where the result
+// is small.
+//
+// At low precision the C library's functions are used instead, and a
+// little above it their double-double counterparts, whenever their error
+// bound, from that of the argument rounded and of the function itself,
+// leaves DOUBLE_GUARD_BITS to spare.
+namespace {
+    constexpr int DOUBLE_GUARD_BITS = 8;
+    constexpr int DOUBLE_BITS =
+        std::numeric_limits<double>::digits - 1 - DOUBLE_GUARD_BITS;
+    constexpr int DOUBLE_DOUBLE_BITS =
+        2 * std::numeric_limits<double>::digits - 8 - DOUBLE_GUARD_BITS;
+
+    // whether m 2^e is far enough inside the range of double for to_double
+    // and to_double_double to keep all the bits they can, and for products
+    // and quotients of two such to stay normal
+    bool in_double_range(const mp::ZZ& m, long e)
+    {
+        const long b = msb(m, e);
+        return m.is_zero() || (b > -480 && b < 480);
+    }
+
+    // The unevaluated sum hi + lo, with |lo| at most half an ulp of hi,
+    // good to 106 bits. Sums and products are Dekker's, without a fused
+    // multiply-add; quotients are those of the QD library by Hida, Li and
+    // Bailey. Each is good to a few units in 2^-106 of the result.
+    struct DoubleDouble {
+        double hi;
+        double lo;
+    };
+
+    // |a| >= |b|
+    DoubleDouble quick_two_sum(double a, double b)
+    {
+        const double s = a + b;
+        return {s, b - (s - a)};
+    }
+
+    DoubleDouble two_sum(double a, double b)
+    {
+        const double s = a + b;
+        const double v = s - a;
+        return {s, (a - (s - v)) + (b - v)};
+    }
+
+    DoubleDouble two_prod(double a, double b)
+    {
+        // both split into halves of 26 bits
+        const double split = 134217729.0;
+
+        const double ta = split * a;
+        const double ah = ta - (ta - a);
+        const double al = a - ah;
+
+        const double tb = split * b;
+        const double bh = tb - (tb - b);
+        const double bl = b - bh;
+
+        const double p = a * b;
+        return {p, ((ah * bh - p) + ah * bl + al * bh) + al * bl};
+    }
+
+    DoubleDouble operator-(const DoubleDouble& a)
+    {
+        return {-a.hi, -a.lo};
+    }
+
+    DoubleDouble operator+(const DoubleDouble& a, const DoubleDouble& b)
+    {
+        const DoubleDouble s = two_sum(a.hi, b.hi);
+        const DoubleDouble t = two_sum(a.lo, b.lo);
+        const DoubleDouble u = quick_two_sum(s.hi, s.lo + t.hi);
+        return quick_two_sum(u.hi, u.lo + t.lo);
+    }
+
+    DoubleDouble operator-(const DoubleDouble& a, const DoubleDouble& b)
+    {
+        return a + -b;
+    }
+
+    DoubleDouble operator*(const DoubleDouble& a, const DoubleDouble& b)
+    {
+        const DoubleDouble p = two_prod(a.hi, b.hi);
+        return quick_two_sum(p.hi, p.lo + (a.hi * b.lo + a.lo * b.hi));
+    }
+
+    DoubleDouble operator/(const DoubleDouble& a, double b)
+    {
+        const double q1 = a.hi / b;
+        const DoubleDouble p = two_prod(q1, b);
+        const DoubleDouble s = two_sum(a.hi, -p.hi);
+        const double q2 = (s.hi + ((s.lo - p.lo) + a.lo)) / b;
+        return quick_two_sum(q1, q2);
+    }
+
+    DoubleDouble operator/(const DoubleDouble& a, const DoubleDouble& b)
+    {
+        const double q1 = a.hi / b.hi;
+        DoubleDouble r = a - b * DoubleDouble{q1, 0};
+        const double q2 = r.hi / b.hi;
+        r = r - b * DoubleDouble{q2, 0};
+        const double q3 = r.hi / b.hi;
+        return quick_two_sum(q1, q2) + DoubleDouble{q3, 0};
+    }
+
+    DoubleDouble dd_ldexp(const DoubleDouble& a, long n)
+    {
+        return {std::ldexp(a.hi, static_cast<int>(n)),
+                std::ldexp(a.lo, static_cast<int>(n))};
+    }
+
+    // m 2^e, which must be in_double_range, from its leading 127 bits
+    // a 2^64 + b: a rounded to a double, and the rest
+    DoubleDouble to_double_double(const mp::ZZ& m, long e)
+    {
+        const long s = static_cast<long>(m.no_bits()) - 127;
+        const std::uint64_t a = bits_from(m, s + 64);
+        const std::uint64_t b = bits_from(m, s);
+
+        // a < 2^63, so its rounding fits, and differs from it by less than
+        // 2^10
+        const double h = static_cast<double>(a);
+        const auto d = static_cast<std::int64_t>(a - static_cast<std::uint64_t>(h));
+        const double l = d + std::ldexp(static_cast<double>(b), -64);
+
+        const DoubleDouble r = dd_ldexp(quick_two_sum(h, l), s + 64 + e);
+
+        return m.is_negative() ? -r : r;
+    }
+
+    // a 2^n, truncated towards zero
+    void shift(mp::ZZ& a, long n)
+    {
+        if (n > 0 && !a.is_zero())
+            a <<= static_cast<unsigned>(n);
+        else if (n < 0)
+            a >>= static_cast<unsigned>(-n);
+    }
+
+    mp::ZZ fixed_one(long p)
+    {
+        mp::ZZ a(1);
+        shift(a, p);
+        return a;
+    }
+
+    // m 2^e with p fractional bits
+    mp::ZZ to_fixed(mp::ZZ m, long e, long p)
+    {
+        shift(m, e + p);
+        return m;
+    }
+
+    // a b and a / b, all with p fractional bits
+    mp::ZZ mul(const mp::ZZ& a, const mp::ZZ& b, long p)
+    {
+        mp::ZZ r(a);
+        r *= b;
+        shift(r, -p);
+        return r;
+    }
+
+    mp::ZZ div(const mp::ZZ& a, const mp::ZZ& b, long p)
+    {
+        mp::ZZ r(a);
+        shift(r, p);
+        r /= b;
+        return r;
+    }
+
+    // d with p fractional bits, of which no more than 50 are correct
+    mp::ZZ from_double(double d, long p)
+    {
+        const long s = std::min(p, 50L);
+        mp::ZZ a = to_zz(std::llround(std::ldexp(d, s)));
+        shift(a, p - s);
+        return a;
+    }
+
+    // the bits by which the rounding errors of a series or iteration
+    // carried out with p fractional bits may add up
+    long extra_bits(long p)
+    {
+        return 8 + bit_length(p);
+    }
+
+    // ArcTan(1/q), or ArcTanh(1/q) if not alternating, with p fractional
+    // bits, for q^2 that fits an int
+    mp::ZZ arctan_inv(int q, bool alternating, long p)
+    {
+        const long r = p + extra_bits(p);
+
+        mp::ZZ t = fixed_one(r);
+        t /= q;
+        mp::ZZ s(t);
+
+        for (int k = 1; !t.is_zero(); ++k) {
+            t /= q * q;
+
+            mp::ZZ u(t);
+            u /= 2 * k + 1;
+
+            if (alternating && (k & 1))
+                s -= u;
+            else
+                s += u;
+        }
+
+        shift(s, p - r);
+        return s;
+    }
+
+    // Pi, Ln(2) and Euler's constant are kept with the most fractional bits
+    // asked for so far, up to MAX_CACHED_BITS each, and fewer are served by
+    // cutting off the surplus bits; more are computed afresh and replace the
+    // cached value
+    constexpr long MAX_CACHED_BITS = 1L << 22;
+
+    struct CachedConstant {
+        mp::ZZ (*compute)(long p);
+        mp::ZZ value;
+        long bits;
+    };
+
+    std::mutex constants_mutex;
+
+    mp::ZZ cached(CachedConstant& c, long p)
+    {
+        {
+            std::lock_guard<std::mutex> lock(constants_mutex);
+
+            if (c.bits >= p) {
+                mp::ZZ a(c.value);
+                shift(a, p - c.bits);
+                return a;
+            }
+        }
+
+        mp::ZZ a = c.compute(p);
+
+        if (p <= MAX_CACHED_BITS) {
+            std::lock_guard<std::mutex> lock(constants_mutex);
+
+            if (c.bits < p) {
+                c.value = a;
+                c.bits = p;
+            }
+        }
+
+        return a;
+    }
+
+    // P, Q and T of the terms a to b of the Chudnovskys' series
+    //   1/Pi = 12 Sum (-1)^k (6k)! (13591409 + 545140134 k) /
+    //              ((3k)! k!^3 640320^(3k + 3/2))
+    // split in halves, so that the big products are of numbers of about the
+    // same size
+    void chudnovsky(long a, long b, mp::ZZ& P, mp::ZZ& Q, mp::ZZ& T)
+    {
+        if (b - a == 1) {
+            if (a == 0) {
+                P = mp::ZZ(1);
+                Q = mp::ZZ(1);
+            } else {
+                P = to_zz(6 * a - 5);
+                P *= to_zz(2 * a - 1);
+                P *= to_zz(6 * a - 1);
+                P.neg();
+                Q = to_zz(a);
+                Q.pow(3);
+                Q *= to_zz(10939058860032000);  // 640320^3 / 24
+            }
+
+            T = P;
+            T *= to_zz(13591409 + 545140134 * static_cast<std::int64_t>(a));
+            return;
+        }
+
+        const long m = (a + b) / 2;
+
+        mp::ZZ P2, Q2, T2;
+        chudnovsky(a, m, P, Q, T);
+        chudnovsky(m, b, P2, Q2, T2);
+
+        T *= Q2;
+        T.addmul(P, T2);
+        P *= P2;
+        Q *= Q2;
+    }
+
+    // Pi = 426880 Sqrt(10005) Q / T, with each term adding about 47 bits
+    mp::ZZ pi_series(long p)
+    {
+        const long q = p + 16;
+
+        mp::ZZ P, Q, T;
+        chudnovsky(0, q / 47 + 2, P, Q, T);
+
+        mp::NN s(10005);
+        s <<= static_cast<unsigned>(2 * q);
+        s.isqrt();
+
+        mp::ZZ a(s);
+        a *= Q;
+        a *= 426880;
+        a /= T;
+        shift(a, p - q);
+        return a;
+    }
+
+    // Ln(2) = 18 ArcTanh(1/26) - 2 ArcTanh(1/4801) + 8 ArcTanh(1/8749)
+    mp::ZZ ln2_series(long p)
+    {
+        mp::ZZ a = arctan_inv(26, false, p + 6);
+        a *= 18;
+        a.submul(arctan_inv(4801, false, p + 6), mp::ZZ(2));
+        a.addmul(arctan_inv(8749, false, p + 6), mp::ZZ(8));
+        shift(a, -6);
+        return a;
+    }
+
+    CachedConstant pi_constant = {pi_series, mp::ZZ(), 0};
+    CachedConstant ln2_constant = {ln2_series, mp::ZZ(), 0};
+
+    mp::ZZ pi_fixed(long p)
+    {
+        return cached(pi_constant, p);
+    }
+
+    mp::ZZ ln2_fixed(long p)
+    {
+        return cached(ln2_constant, p);
+    }
+
+    // the number of halvings of an argument that best balances the
+    // terms of a series with p fractional bits against the squarings
+    // or doublings that undo them
+    long halvings(long p)
+    {
+        return static_cast<long>(std::sqrt(static_cast<double>(p)) / 2);
+    }
+
+    // Exp(x) for |x| <= 1; each squaring doubles the relative error
+    mp::ZZ exp_small(const mp::ZZ& x, long p)
+    {
+        const long s = halvings(p);
+        const long q = p + s + extra_bits(p);
+
+        mp::ZZ r(x);
+        shift(r, q - p - s);
+
+        mp::ZZ y = fixed_one(q);
+        mp::ZZ t(y);
+
+        for (int k = 1;; ++k) {
+            t = mul(t, r, q);
+            t /= k;
+
+            if (t.is_zero())
+                break;
+
+            y += t;
+        }
+
+        for (long i = 0; i < s; ++i) {
+            y.sqr();
+            shift(y, -q);
+        }
+
+        shift(y, p - q);
+        return y;
+    }
+
+    // Sin(x) and Cos(x) for |x| <= 1, by Sin(2 t) = 2 Sin(t) Cos(t) and
+    // Cos(2 t) = 1 - 2 Sin(t)^2; each doubling about doubles the error
+    void sin_cos_small(const mp::ZZ& x, long p, mp::ZZ& sin, mp::ZZ& cos)
+    {
+        const long s = halvings(p);
+        const long q = p + s + extra_bits(p);
+
+        mp::ZZ r(x);
+        shift(r, q - p - s);
+
+        const mp::ZZ r2 = mul(r, r, q);
+
+        sin = r;
+        mp::ZZ t(r);
+
+        for (int k = 1; !t.is_zero(); ++k) {
+            t = mul(t, r2, q);
+            t /= 2 * k;
+            t /= 2 * k + 1;
+            t.neg();
+            sin += t;
+        }
+
+        const mp::ZZ one = fixed_one(q);
+
+        cos = one;
+        t = one;
+
+        for (int k = 1; !t.is_zero(); ++k) {
+            t = mul(t, r2, q);
+            t /= 2 * k - 1;
+            t /= 2 * k;
+            t.neg();
+            cos += t;
+        }
+
+        for (long i = 0; i < s; ++i) {
+            mp::ZZ c = mul(sin, sin, q);
+            shift(c, 1);
+            c.neg();
+            c += one;
+
+            sin = mul(sin, cos, q);
+            shift(sin, 1);
+
+            cos = std::move(c);
+        }
+
+        shift(sin, p - q);
+        shift(cos, p - q);
+    }
+
+    // Sin and Cos of m 2^e, reduced by the multiple k Pi/2 nearest to it;
+    // Pi is taken with as many more bits as k has
+    void sin_cos_fixed(const mp::ZZ& m, long e, long p, mp::ZZ& sin, mp::ZZ& cos)
+    {
+        const long q = p + std::max(0L, msb(m, e)) + 8;
+
+        const mp::ZZ x = to_fixed(m, e, q);
+        const mp::ZZ h = pi_fixed(q - 1);
+
+        // k = round(x / h)
+        mp::ZZ k(x);
+        k.abs();
+        shift(k, 1);
+        k += h;
+        mp::ZZ d(h);
+        shift(d, 1);
+        k /= d;
+
+        if (x.is_negative())
+            k.neg();
+
+        mp::ZZ r(x);
+        r.submul(k, h);
+        shift(r, p - q);
+
+        sin_cos_small(r, p, sin, cos);
+
+        const bool negative = k.is_negative();
+        k.abs();
+
+        unsigned quadrant = k.is_zero() ? 0 : k.to_NN().raw_limbs().front() & 3;
+        if (negative)
+            quadrant = (4 - quadrant) % 4;
+
+        if (quadrant & 1) {
+            std::swap(sin, cos);
+            cos.neg();
+        }
+
+        if (quadrant & 2) {
+            sin.neg();
+            cos.neg();
+        }
+    }
+
+    // Sin and Cos of m 2^e with as many fractional bits as it takes for
+    // the ones needed to have n significant bits, which near a multiple
+    // of Pi/2 is more than the argument would suggest; this is returned
+    long sin_cos(const mp::ZZ& m,
+                 long e,
+                 long n,
+                 bool need_sin,
+                 bool need_cos,
+                 mp::ZZ& sin,
+                 mp::ZZ& cos)
+    {
+        long p = n + 16 + std::max(0L, -msb(m, e));
+
+        for (;;) {
+            sin_cos_fixed(m, e, p, sin, cos);
+
+            long missing = 0;
+            if (need_sin)
+                missing = std::max(missing, n - static_cast<long>(sin.no_bits()));
+            if (need_cos)
+                missing = std::max(missing, n - static_cast<long>(cos.no_bits()));
+
+            if (missing <= 0)
+                return p;
+
+            p += missing + 16;
+        }
+    }
+
+    // Ln(f) for 1/2 <= f <= 2, by y <- y + f Exp(-y) - 1 from the value
+    // at half the precision
+    mp::ZZ ln_small(const mp::ZZ& f, long p)
+    {
+        if (p <= 50)
+            return from_double(std::log(to_double(f, -p)), p);
+
+        const long h = p / 2 + 8;
+
+        mp::ZZ y(f);
+        shift(y, h - p);
+        y = ln_small(y, h);
+        shift(y, p - h);
+
+        mp::ZZ x(y);
+        x.neg();
+
+        mp::ZZ d = mul(f, exp_small(x, p), p);
+        d -= fixed_one(p);
+        y += d;
+
+        return y;
+    }
+
+    // ArcTan(z) for 0 <= z <= 1, by y <- y + ArcTan(Tan(y - ArcTan(z)))
+    // from the value at half the precision, with the arctangent of the
+    // small correction taken to be the correction itself
+    mp::ZZ atan_small(const mp::ZZ& z, long p)
+    {
+        if (p <= 50)
+            return from_double(std::atan(to_double(z, -p)), p);
+
+        const long h = p / 2 + 8;
+
+        mp::ZZ y(z);
+        shift(y, h - p);
+        y = atan_small(y, h);
+        shift(y, p - h);
+
+        mp::ZZ sin, cos;
+        sin_cos_small(y, p, sin, cos);
+
+        // (z Cos(y) - Sin(y)) / (Cos(y) + z Sin(y))
+        mp::ZZ num = mul(z, cos, p);
+        num -= sin;
+        mp::ZZ den = mul(z, sin, p);
+        den += cos;
+
+        y += div(num, den, p);
+
+        return y;
+    }
+
+    // Euler's constant by Brent and McMillan: with B_k = (n^k / k!)^2 and
+    // A_k = B_k (H_k - Ln(n)), it is Sum A_k / Sum B_k to within about
+    // Exp(-4 n)
+    mp::ZZ euler_gamma_series(long p)
+    {
+        const long q = p + extra_bits(p);
+        const long n = static_cast<long>(q * std::log(2.0) / 4) + 2;
+        const long k = bit_length(n);
+
+        mp::ZZ a = ln_small(to_fixed(to_zz(n), -k, q), q);
+        a.addmul(ln2_fixed(q), to_zz(k));
+        a.neg();
+        mp::ZZ b = fixed_one(q);
+
+        mp::ZZ u(a);
+        mp::ZZ v(b);
 
-    // TODO this round-off code is not correct yet, but will work in most cases
-    // This is a bit of a messy way to round off numbers. It is probably
-    // incorrect, even. When precision drops one digit, it rounds off the last
-    // ten digits. So the following code is probably only correct if
-    // aPrecision>=num.iPrecision or if aPrecision < num.iPrecision-10
-    if (aBasePrecision < num.iPrecision) {
-        if (num.iExp > 1)
-            num.RoundBits();
+        const mp::ZZ n2 = to_zz(static_cast<std::int64_t>(n) * n);
+
+        for (int i = 1; !a.is_zero() || !b.is_zero(); ++i) {
+            b *= n2;
+            b /= i;
+            b /= i;
+
+            a *= n2;
+            a /= i;
+            a += b;
+            a /= i;
+
+            u += a;
+            v += b;
+        }
+
+        mp::ZZ g = div(u, v, q);
+        shift(g, p - q);
+        return g;
     }
-    num.ChangePrecision(aBasePrecision);
 
-    if (!IsInt()) {
-        for (;;) {
+    CachedConstant euler_gamma_constant = {euler_gamma_series, mp::ZZ(), 0};
 
-            const int ns = num.size();
-            bool greaterOne = false;
-            if (num.iExp >= int(ns))
-                break;
-            for (int i = num.iExp; i < ns; i++) {
-                if (num[i] != 0) {
-                    if (!(i == num.iExp && num[i] < 10000 &&
-                          num.iTensExp == 0)) {
-                        greaterOne = true;
-                        break;
-                    }
-                }
-            }
-            if (!greaterOne)
-                break;
-            PlatDoubleWord carry = 0;
-            BaseDivideInt(num, 10, WordBase, carry);
-            num.iTensExp++;
+    // Ln(2) and Pi/2 to 107 bits
+    const DoubleDouble DD_LN2 = {0x1.62e42fefa39efp-1, 0x1.abc9e3b39803fp-56};
+    const DoubleDouble DD_PI_2 = {0x1.921fb54442d18p+0, 0x1.1a62633145c07p-54};
+
+    // The double-double counterparts of the above, reducing the argument
+    // the same way, for |x| < 600: Exp(x) - 1 at 2^-10 of the reduced
+    // argument brought back by ten squarings of 1 plus it, and Sin and Cos
+    // summed at |x| <= Pi/4; Ln, ArcTan and ArcSin take one Newton step
+    // from the C library's value.
+    DoubleDouble dd_exp(const DoubleDouble& x)
+    {
+        const double k = std::nearbyint(x.hi / DD_LN2.hi);
+        const DoubleDouble r = dd_ldexp(x - DD_LN2 * DoubleDouble{k, 0}, -10);
+
+        DoubleDouble s = r;
+        DoubleDouble t = r;
+        for (int i = 2; std::abs(t.hi) > std::ldexp(std::abs(s.hi), -108); ++i) {
+            t = t * r / i;
+            s = s + t;
         }
+
+        for (int i = 0; i < 10; ++i)
+            s = s * (s + DoubleDouble{2, 0});
+
+        return dd_ldexp(s + DoubleDouble{1, 0}, static_cast<long>(k));
     }
 
-    ANumberToString(aResult, num, aBase, !_zz);
-}
+    DoubleDouble dd_ln(const DoubleDouble& x)
+    {
+        const DoubleDouble y = {std::log(x.hi), 0};
+        return y + (x * dd_exp(-y) - DoubleDouble{1, 0});
+    }
 
-double BigNumber::Double() const
-{
-    std::string str;
+    void dd_sin_cos(const DoubleDouble& x, DoubleDouble& sin, DoubleDouble& cos)
+    {
+        const double k = std::nearbyint(x.hi / DD_PI_2.hi);
+        const DoubleDouble r = x - DD_PI_2 * DoubleDouble{k, 0};
+        const DoubleDouble r2 = r * r;
+
+        DoubleDouble s = r;
+        DoubleDouble c = {1, 0};
+        DoubleDouble ts = s;
+        DoubleDouble tc = c;
+        for (int i = 2; std::abs(ts.hi) > std::ldexp(std::abs(r.hi), -108) ||
+                        std::abs(tc.hi) > std::ldexp(1.0, -108);
+             i += 2) {
+            tc = -(tc * r2) / (static_cast<double>(i - 1) * i);
+            ts = -(ts * r2) / (static_cast<double>(i) * (i + 1));
+            c = c + tc;
+            s = s + ts;
+        }
 
-    if (IsInt()) {
-        str = _zz->to_string();
-    } else {
-        ANumber num(*iNumber);
-        ANumberToString(str, num, 10);
+        switch (static_cast<long>(k) & 3) {
+        case 0:
+            sin = s;
+            cos = c;
+            break;
+        case 1:
+            sin = c;
+            cos = -s;
+            break;
+        case 2:
+            sin = -s;
+            cos = -c;
+            break;
+        default:
+            sin = -c;
+            cos = s;
+        }
     }
 
-    std::istringstream is(str);
-    double d;
-    is >> d;
-    return d;
-}
+    DoubleDouble dd_atan(const DoubleDouble& x)
+    {
+        // ArcTan(x) = +-Pi/2 - ArcTan(1/x), where the step converges fast
+        if (std::abs(x.hi) > 1) {
+            const DoubleDouble y = dd_atan(DoubleDouble{1, 0} / x);
+            return (x.hi > 0 ? DD_PI_2 : -DD_PI_2) - y;
+        }
 
-void BigNumber::Multiply(const BigNumber& aX,
-                         const BigNumber& aY,
-                         int aPrecision)
-{
-    if (aX.IsInt() && aY.IsInt()) {
-        BecomeInt();
-        *_zz = *aX._zz;
-        *_zz *= *aY._zz;
+        const DoubleDouble y = {std::atan(x.hi), 0};
+        DoubleDouble s, c;
+        dd_sin_cos(y, s, c);
+        return y + (x * c - s) * c;
+    }
 
-        return;
+    // |x| < 1
+    DoubleDouble dd_asin(const DoubleDouble& x)
+    {
+        const DoubleDouble y = {std::asin(x.hi), 0};
+        DoubleDouble s, c;
+        dd_sin_cos(y, s, c);
+        return y + (x - s) / c;
     }
 
-    if (aPrecision < aX.GetPrecision())
-        aPrecision = aX.GetPrecision();
+    DoubleDouble dd_sqrt(const DoubleDouble& x)
+    {
+        const double t = 1 / std::sqrt(x.hi);
+        const double y = x.hi * t;
+        return two_sum(y, (x - two_prod(y, y)).hi * (t / 2));
+    }
+}
 
-    if (aPrecision < aY.GetPrecision())
-        aPrecision = aY.GetPrecision();
+bool BigNumber::SetDouble(double aValue, double aError, int aPrecision)
+{
+    if (!std::isnormal(aValue) ||
+        !(std::ldexp(aError, aPrecision + DOUBLE_GUARD_BITS) <=
+          std::ldexp(std::abs(aValue), std::numeric_limits<double>::digits)))
+        return false;
 
-    BecomeFloat(bits_to_digits(aPrecision, 10));
+    int k;
+    const double f = std::frexp(aValue, &k);
+    const int d = std::numeric_limits<double>::digits;
 
-    BigNumber x(aX);
-    x.BecomeFloat(aPrecision);
-    BigNumber y(aY);
-    y.BecomeFloat(aPrecision);
+    SetFloat(to_zz(static_cast<std::int64_t>(std::ldexp(f, d))), k - d, aPrecision);
+    return true;
+}
 
-    ANumber a1(*x.iNumber);
-    ANumber a2(*y.iNumber);
-    ::Multiply(*iNumber, a1, a2);
+bool BigNumber::SetDoubleDouble(double aHi,
+                                double aLo,
+                                double aError,
+                                int aPrecision)
+{
+    const int d = std::numeric_limits<double>::digits;
+
+    if (!std::isnormal(aHi) ||
+        !(std::abs(aLo) <= std::ldexp(std::abs(aHi), -d)) ||
+        !(std::ldexp(aError, aPrecision + DOUBLE_GUARD_BITS) <=
+          std::ldexp(std::abs(aHi), 2 * d)))
+        return false;
+
+    // hi + lo = m 2^e, the 53 bits of hi at the top of 117 and lo, which is
+    // less than 2^64 of the unit, truncated to whole units
+    int k;
+    const double f = std::frexp(std::abs(aHi), &k);
+    const std::uint64_t h = static_cast<std::uint64_t>(std::ldexp(f, d));
+    const long e = k - d - 64;
+
+    const std::uint64_t l =
+        static_cast<std::uint64_t>(std::ldexp(std::abs(aLo), -static_cast<int>(e)));
+
+    mp::ZZ m = (aLo < 0) == (aHi < 0) ? to_zz(h, l) : to_zz(h - (l != 0), -l);
+    if (aHi < 0)
+        m.neg();
+
+    SetFloat(std::move(m), e, aPrecision);
+    return true;
 }
 
-void BigNumber::Add(const BigNumber& aX, const BigNumber& aY, int aPrecision)
+void BigNumber::Exp(const BigNumber& aX, int aPrecision)
 {
-    if (aX.IsInt() && aY.IsInt()) {
-        BecomeInt();
-        *_zz = *aX._zz;
-        *_zz += *aY._zz;
+    const mp::ZZ& m = aX.Mantissa();
+    const long e = aX.Exponent();
+
+    if (m.is_zero()) {
+        *this = BigNumber(mp::ZZ(1));
         return;
     }
 
+    // beyond the exponents that fit a long
+    if (msb(m, e) > 40)
+        throw LispErrInvalidArg();
 
-    if (aPrecision < aX.GetPrecision())
-        aPrecision = aX.GetPrecision();
-    if (aPrecision < aY.GetPrecision())
-        aPrecision = aY.GetPrecision();
+    if (aPrecision <= DOUBLE_BITS) {
+        const double x = to_double(m, e);
+        const double r = std::exp(x);
+        if (SetDouble(r, 2 * r * (1 + std::abs(x)), aPrecision))
+            return;
+    }
 
-    BecomeFloat(aPrecision);
+    if (aPrecision <= DOUBLE_DOUBLE_BITS && msb(m, e) < 9 &&
+        in_double_range(m, e)) {
+        const DoubleDouble x = to_double_double(m, e);
+        const DoubleDouble r = dd_exp(x);
+        if (SetDoubleDouble(r.hi, r.lo, (16 + 8 * std::abs(x.hi)) * r.hi, aPrecision))
+            return;
+    }
 
-    BigNumber x(aX);
-    BigNumber y(aY);
+    const long bits = aPrecision + GUARD_BITS;
+    const long p = bits + 16;
 
-    x.BecomeFloat(aPrecision);
-    y.BecomeFloat(aPrecision);
+    // Exp(x) = 2^k Exp(x - k Ln(2)), with Ln(2) to as many more bits as k
+    // has
+    const long k = std::lround(to_double(m, e) / std::log(2.0));
+    const long q = p + bit_length(std::abs(k)) + 2;
 
+    mp::ZZ r = to_fixed(m, e, q);
+    r.submul(ln2_fixed(q), to_zz(k));
+    shift(r, p - q);
 
-    ::Add(*iNumber, *x.iNumber, *y.iNumber);
+    mp::ZZ y = exp_small(r, p);
+    long ye = k - p;
+    round_to(y, ye, bits);
 
-    iNumber->SetPrecision(aPrecision);
+    SetFloat(std::move(y), ye, aPrecision);
 }
 
-void BigNumber::Negate(const BigNumber& aX)
+void BigNumber::Ln(const BigNumber& aX, int aPrecision)
 {
-    if (this == &aX) {
-        if (IsInt())
-            _zz->neg();
-        else
-            iNumber->Negate();
+    const mp::ZZ& m = aX.Mantissa();
+    const long e = aX.Exponent();
 
-        return;
+    if (m.is_zero() || m.is_negative())
+        throw LispErrInvalidArg();
+
+    if (aPrecision <= DOUBLE_BITS && in_double_range(m, e)) {
+        const double r = std::log(to_double(m, e));
+        if (SetDouble(r, 2 * std::abs(r) + 2, aPrecision))
+            return;
     }
-    if (aX.IsInt()) {
-        BecomeInt();
-        *_zz = *aX._zz;
-        _zz->neg();
-    } else {
-        BecomeFloat(aX.iPrecision);
-        iNumber->CopyFrom(*aX.iNumber);
-        iNumber->Negate();
+
+    if (aPrecision <= DOUBLE_DOUBLE_BITS && in_double_range(m, e)) {
+        // the Newton step leaves half the square of the error of the C
+        // library's value
+        const DoubleDouble r = dd_ln(to_double_double(m, e));
+        const double d = std::abs(r.hi) + 1;
+        if (SetDoubleDouble(r.hi, r.lo, 8 * std::abs(r.hi) + 16 + 2 * d * d, aPrecision))
+            return;
     }
-}
 
-void BigNumber::Divide(const BigNumber& aX, const BigNumber& aY, int aPrecision)
-{
-    if (aX.IsInt() && aY.IsInt()) {
-        if (aY._zz->is_zero())
-            throw LispErrInvalidArg();
+    const long bits = aPrecision + GUARD_BITS;
+    long p = bits + 16;
+
+    // Ln(x) = k Ln(2) + Ln(f) for x = f 2^k with 1/Sqrt(2) <= f < Sqrt(2)
+    long k = msb(m, e);
+    if (to_double(m, e - k) < std::sqrt(0.5))
+        k -= 1;
+
+    // Ln(f) is about f - 1, which may be small
+    if (k == 0) {
+        mp::ZZ d;
+        long de;
+        add(m, e, mp::ZZ(-1), 0, std::min(e, 0L), d, de);
+
+        if (d.is_zero()) {
+            if (aX.IsInt())
+                *this = BigNumber(mp::ZZ(0));
+            else
+                SetFloat(mp::ZZ(0), 0, aPrecision);
+            return;
+        }
 
-        BecomeInt();
-        _zz.reset(new mp::ZZ(*aX._zz));
-        *_zz /= *aY._zz;
-    } else {
-        int aPrecision = iPrecision;
+        p += std::max(0L, -msb(d, de));
+    }
 
-        if (aPrecision < aX.GetPrecision())
-            aPrecision = aX.GetPrecision();
-        if (aPrecision < aY.GetPrecision())
-            aPrecision = aY.GetPrecision();
+    const long q = p + bit_length(std::abs(k)) + 2;
 
-        int digitPrecision = bits_to_digits(aPrecision, 10);
-        BecomeFloat(aPrecision);
+    mp::ZZ y = ln_small(to_fixed(m, e - k, q), q);
+    y.addmul(ln2_fixed(q), to_zz(k));
+    long ye = -q;
+    round_to(y, ye, bits);
 
-        BigNumber x(aX);
-        x.BecomeFloat(digitPrecision);
-        BigNumber y(aY);
-        y.BecomeFloat(digitPrecision);
+    SetFloat(std::move(y), ye, aPrecision);
+}
 
-        iPrecision = aPrecision;
-        iNumber->iPrecision = digitPrecision;
+void BigNumber::Sin(const BigNumber& aX, int aPrecision)
+{
+    const mp::ZZ& m = aX.Mantissa();
 
-        ANumber a1(*x.iNumber);
-        a1.ChangePrecision(digitPrecision);
-        ANumber a2(*y.iNumber);
-        a2.ChangePrecision(digitPrecision);
-        ANumber remainder(digitPrecision);
+    if (m.is_zero()) {
+        *this = aX;
+        return;
+    }
 
-        if (a2.IsZero())
-            throw LispErrInvalidArg();
+    if (aPrecision <= DOUBLE_BITS) {
+        const double x = to_double(m, aX.Exponent());
+        if (SetDouble(std::sin(x), 2 + 2 * std::abs(x), aPrecision))
+            return;
+    }
 
-        ::Divide(*iNumber, remainder, a1, a2);
+    if (aPrecision <= DOUBLE_DOUBLE_BITS && msb(m, aX.Exponent()) < 30 &&
+        in_double_range(m, aX.Exponent())) {
+        const DoubleDouble x = to_double_double(m, aX.Exponent());
+        DoubleDouble sin, cos;
+        dd_sin_cos(x, sin, cos);
+        if (SetDoubleDouble(sin.hi, sin.lo, 16 + 8 * std::abs(x.hi), aPrecision))
+            return;
     }
-}
 
-void BigNumber::ShiftLeft(const BigNumber& aX, int aNrToShift)
-{
-    if (this != &aX)
-        *this = aX;
+    const long bits = aPrecision + GUARD_BITS;
 
-    BecomeInt();
+    mp::ZZ sin, cos;
+    long e = -sin_cos(m, aX.Exponent(), bits + 8, true, false, sin, cos);
+    round_to(sin, e, bits);
 
-    *_zz <<= aNrToShift;
+    SetFloat(std::move(sin), e, aPrecision);
 }
 
-void BigNumber::ShiftRight(const BigNumber& aX, int aNrToShift)
+void BigNumber::Cos(const BigNumber& aX, int aPrecision)
 {
-    if (this != &aX)
-        *this = aX;
+    const mp::ZZ& m = aX.Mantissa();
 
-    BecomeInt();
+    if (m.is_zero()) {
+        *this = BigNumber(mp::ZZ(1));
+        return;
+    }
 
-    *_zz >>= aNrToShift;
-}
+    if (aPrecision <= DOUBLE_BITS) {
+        const double x = to_double(m, aX.Exponent());
+        if (SetDouble(std::cos(x), 2 + 2 * std::abs(x), aPrecision))
+            return;
+    }
 
-void BigNumber::BitAnd(const BigNumber& aX, const BigNumber& aY)
-{
-    BecomeInt();
+    if (aPrecision <= DOUBLE_DOUBLE_BITS && msb(m, aX.Exponent()) < 30 &&
+        in_double_range(m, aX.Exponent())) {
+        const DoubleDouble x = to_double_double(m, aX.Exponent());
+        DoubleDouble sin, cos;
+        dd_sin_cos(x, sin, cos);
+        if (SetDoubleDouble(cos.hi, cos.lo, 16 + 8 * std::abs(x.hi), aPrecision))
+            return;
+    }
 
-    BigNumber x(aX);
-    x.BecomeInt();
-    BigNumber y(aY);
-    y.BecomeInt();
+    const long bits = aPrecision + GUARD_BITS;
 
-    *_zz = *x._zz;
-    *_zz &= *y._zz;
+    mp::ZZ sin, cos;
+    long e = -sin_cos(m, aX.Exponent(), bits + 8, false, true, sin, cos);
+    round_to(cos, e, bits);
+
+    SetFloat(std::move(cos), e, aPrecision);
 }
 
-void BigNumber::BitOr(const BigNumber& aX, const BigNumber& aY)
+void BigNumber::Tan(const BigNumber& aX, int aPrecision)
 {
-    BecomeInt();
+    const mp::ZZ& m = aX.Mantissa();
 
-    BigNumber x(aX);
-    x.BecomeInt();
-    BigNumber y(aY);
-    y.BecomeInt();
-
-    *_zz = *x._zz;
-    *_zz |= *y._zz;
-    _zz->abs();
-}
+    if (m.is_zero()) {
+        *this = aX;
+        return;
+    }
 
-void BigNumber::BitXor(const BigNumber& aX, const BigNumber& aY)
-{
-    BecomeInt();
+    if (aPrecision <= DOUBLE_BITS) {
+        const double x = to_double(m, aX.Exponent());
+        const double r = std::tan(x);
+        if (SetDouble(r, 2 * std::abs(r) + 2 * std::abs(x) * (1 + r * r), aPrecision))
+            return;
+    }
 
-    BigNumber x(aX);
-    x.BecomeInt();
-    BigNumber y(aY);
-    y.BecomeInt();
+    if (aPrecision <= DOUBLE_DOUBLE_BITS && msb(m, aX.Exponent()) < 30 &&
+        in_double_range(m, aX.Exponent())) {
+        const DoubleDouble x = to_double_double(m, aX.Exponent());
+        DoubleDouble sin, cos;
+        dd_sin_cos(x, sin, cos);
+        const DoubleDouble r = sin / cos;
+        const double t = std::abs(r.hi);
+        if (SetDoubleDouble(r.hi, r.lo, 16 * t + (16 + 8 * std::abs(x.hi)) * (1 + t * t), aPrecision))
+            return;
+    }
 
-    *_zz = *x._zz;
-    *_zz ^= *y._zz;
-    _zz->abs();
-}
+    const long bits = aPrecision + GUARD_BITS;
 
-void BigNumber::BitNot(const BigNumber& aX)
-{
-    BecomeInt();
+    mp::ZZ sin, cos;
+    const long p = sin_cos(m, aX.Exponent(), bits + 8, true, true, sin, cos);
 
-    BigNumber x(aX);
-    x.BecomeInt();
+    mp::ZZ r;
+    long re;
+    divide(sin, -p, cos, -p, bits, r, re);
+    round_to(r, re, bits);
 
-    *_zz = *x._zz;
-    _zz->neg();
-    _zz->abs();
+    SetFloat(std::move(r), re, aPrecision);
 }
 
-/// Bit count operation: return the number of significant bits if integer,
-/// return the binary exponent if float (shortcut for binary logarithm)
-// give BitCount as platform integer
-signed long BigNumber::BitCount() const
+void BigNumber::ArcSin(const BigNumber& aX, int aPrecision)
 {
-    if (_zz) {
-        if (_zz->is_zero())
-            return 0;
-        return _zz->no_bits();
+    const mp::ZZ& m = aX.Mantissa();
+    const long e = aX.Exponent();
+
+    if (m.is_zero()) {
+        *this = aX;
+        return;
     }
 
-    if (iNumber->IsZero())
-        return 0; //-(1L<<30);
+    mp::ZZ a(m);
+    a.abs();
 
-    ANumber num(*iNumber);
+    const int c = compare(a, e, mp::ZZ(1), 0);
+    if (c > 0)
+        throw LispErrInvalidArg();
 
-    if (num.iTensExp < 0) {
-        int digs = WordDigits(num.iPrecision, 10);
-        PlatWord zero = 0;
-        while (num.iExp < digs) {
-            num.insert(num.begin(), zero);
-            num.iExp++;
-        }
+    if (aPrecision <= DOUBLE_BITS && c < 0) {
+        const double x = to_double(m, e);
+        const double r = std::asin(x);
+        if (SetDouble(r, 2 * std::abs(r) + 2 * std::abs(x) / std::sqrt(1 - x * x), aPrecision))
+            return;
     }
-    while (num.iTensExp < 0) {
-        PlatDoubleWord carry = 0;
-        BaseDivideInt(num, 10, WordBase, carry);
-        num.iTensExp++;
-    }
-    while (num.iTensExp > 0) {
-        BaseTimesInt(num, 10, WordBase);
-        num.iTensExp--;
+
+    // the Newton step leaves an error of half Tan(r) times the square of
+    // that of the C library's value, which grows as Sqrt(1 - x^2) goes to
+    // zero
+    if (aPrecision <= DOUBLE_DOUBLE_BITS && c < 0 && in_double_range(m, e)) {
+        const DoubleDouble x = to_double_double(m, e);
+        const DoubleDouble r = dd_asin(x);
+        const double a = std::abs(x.hi);
+        const double t = a / std::sqrt(1 - a * a);
+        const double d = std::abs(r.hi) + t;
+        if (SetDoubleDouble(r.hi, r.lo, 16 + 16 * std::abs(r.hi) + 8 * t + 2 * t * d * d, aPrecision))
+            return;
     }
 
-    int i, nr = num.size();
-    for (i = nr - 1; i >= 0; i--)
-        if (num[i] != 0)
-            break;
+    const long bits = aPrecision + GUARD_BITS;
+    long p = bits + 16 + std::max(0L, -msb(m, e));
+
+    mp::ZZ y;
 
-    int bits = (i - num.iExp) * sizeof(PlatWord) * 8;
-    if (i >= 0) {
-        PlatWord w = num[i];
-        while (w) {
-            w >>= 1;
-            bits++;
+    if (c == 0) {
+        y = pi_fixed(p - 1);
+    } else {
+        // Sqrt(1 - x^2) = Sqrt((1 - |x|) (1 + |x|)), where 1 - |x| may be
+        // small
+        mp::ZZ d;
+        long de;
+        add(a, e, mp::ZZ(-1), 0, std::min(e, 0L), d, de);
+        p += std::max(0L, -msb(d, de));
+
+        const mp::ZZ x = to_fixed(a, e, p);
+
+        mp::ZZ u = fixed_one(p);
+        u -= x;
+        mp::ZZ v = fixed_one(p);
+        v += x;
+        u *= v;
+
+        mp::NN w(u.to_NN());
+        w.isqrt();
+        const mp::ZZ r(w);
+
+        // ArcSin(x) = ArcTan(x / r) = Pi/2 - ArcTan(r / x)
+        if (x <= r) {
+            y = atan_small(div(x, r, p), p);
+        } else {
+            y = pi_fixed(p - 1);
+            y -= atan_small(div(r, x, p), p);
         }
     }
-    return (bits);
-}
 
-int BigNumber::Sign() const
-{
-    if (IsInt()) {
-        if (_zz->is_negative())
-            return -1;
-        if (_zz->is_zero())
-            return 0;
-        return 1;
-    }
+    if (m.is_negative())
+        y.neg();
 
-    if (iNumber->iNegative)
-        return -1;
-    if (iNumber->IsZero())
-        return 0;
-    return 1;
-}
+    long ye = -p;
+    round_to(y, ye, bits);
 
-void BigNumber::DumpDebugInfo(std::ostream& os) const
-{
-    if (!iNumber)
-        os << "No number representation\n";
-    else
-        iNumber->Print(os, "Number:");
+    SetFloat(std::move(y), ye, aPrecision);
 }
 
-void BigNumber::Floor(const BigNumber& aX)
+void BigNumber::Sqrt(const BigNumber& aX, int aPrecision)
 {
-    if (aX.IsInt()) {
-        BecomeInt();
-        *_zz = *aX._zz;
+    const mp::ZZ& m = aX.Mantissa();
+    const long e = aX.Exponent();
 
+    if (m.is_zero()) {
+        *this = aX;
         return;
     }
 
-    iNumber->CopyFrom(*aX.iNumber);
-    //  If iExp is zero, then we can not look at the decimals and determine the
-    //  floor.
-    // This number has to have digits (see code later in this routine that does
-    // a division). Not extending the digits caused the MathFloor function to
-    // fail on n*10-m where n was an integer. The code below divides away the
-    // 10^-m, but since iExp was zero, this resulted in a premature truncation
-    // (seen when n<0)
-    if (iNumber->iExp == 0)
-        iNumber->ChangePrecision(iNumber->iPrecision);
-
-    if (iNumber->iExp > 1)
-        iNumber->RoundBits();
+    if (m.is_negative())
+        throw LispErrInvalidArg();
 
-    // TODO FIXME slow code! But correct
-    if (iNumber->iTensExp > 0) {
-        while (iNumber->iTensExp > 0) {
-            BaseTimesInt(*iNumber, 10, WordBase);
-            iNumber->iTensExp--;
-        }
-    } else if (iNumber->iTensExp < 0) {
-        while (iNumber->iTensExp < 0) {
-            PlatDoubleWord carry;
-            BaseDivideInt(*iNumber, 10, WordBase, carry);
-            iNumber->iTensExp++;
+    // the root of a square integer is exact
+    if (aX.IsInt()) {
+        mp::NN r(m.to_NN());
+        r.isqrt();
+        mp::NN t(r);
+        t.sqr();
+        if (t == m.to_NN()) {
+            *this = BigNumber(mp::ZZ(r));
+            return;
         }
     }
-    iNumber->ChangePrecision(iNumber->iPrecision);
-    int i = 0;
-    int fraciszero = true;
-    while (i < iNumber->iExp && fraciszero) {
-        PlatWord digit = (*iNumber)[i];
-        if (digit != 0)
-            fraciszero = false;
-        i++;
+
+    if (aPrecision <= DOUBLE_BITS && in_double_range(m, e)) {
+        const double r = std::sqrt(to_double(m, e));
+        if (SetDouble(r, 2 * r, aPrecision))
+            return;
     }
-    iNumber->erase(iNumber->begin(), iNumber->begin() + iNumber->iExp);
-    iNumber->iExp = 0;
 
-    if (iNumber->iNegative && !fraciszero) {
-        ANumber orig(*iNumber);
-        ANumber minone("-1", 10);
-        ::Add(*iNumber, orig, minone);
+    if (aPrecision <= DOUBLE_DOUBLE_BITS && in_double_range(m, e)) {
+        const DoubleDouble r = dd_sqrt(to_double_double(m, e));
+        if (SetDoubleDouble(r.hi, r.lo, 8 * r.hi, aPrecision))
+            return;
     }
 
-    BecomeInt();
-}
+    const long bits = aPrecision + GUARD_BITS;
+    const long p = bits + 16;
 
-void BigNumber::Precision(int aPrecision)
-{ // FIXME
-    if (aPrecision < 0)
-        aPrecision = 0;
+    // x = a 2^(2 k) with 2^(2 p - 2) <= a < 2^(2 p)
+    long t = 2 * p - static_cast<long>(m.no_bits());
+    if ((e - t) % 2)
+        t -= 1;
 
-    if (iNumber && aPrecision > iPrecision)
-        iNumber->ChangePrecision(bits_to_digits(aPrecision, 10));
+    mp::ZZ a(m);
+    if (t >= 0)
+        a <<= static_cast<unsigned>(t);
+    else
+        a >>= static_cast<unsigned>(-t);
 
-    iPrecision = aPrecision;
+    mp::ZZ y = sqrt_fixed(a, p);
+    long ye = (e - t) / 2;
+    round_to(y, ye, bits);
+
+    SetFloat(std::move(y), ye, aPrecision);
 }
 
-// basic object manipulation
-bool BigNumber::Equals(const BigNumber& aOther) const
+void BigNumber::ArcTan(const BigNumber& aX, int aPrecision)
 {
-    if (IsInt() && aOther.IsInt())
-        return *_zz == *aOther._zz;
+    const mp::ZZ& m = aX.Mantissa();
+    const long e = aX.Exponent();
+
+    if (m.is_zero()) {
+        *this = aX;
+        return;
+    }
 
-    if (aOther.IsInt() && aOther._zz->is_zero()) {
-        BigNumber x(*this);
-        std::string s;
-        x.ToString(s, iPrecision);
+    if (aPrecision <= DOUBLE_BITS) {
+        const double x = to_double(m, e);
+        const double r = std::atan(x);
+        if (SetDouble(r, 2 * std::abs(r) + 2 * std::abs(x) / (1 + x * x), aPrecision))
+            return;
     }
 
-    if (IsInt() && _zz->is_zero()) {
-        BigNumber x(aOther);
-        std::string s;
-        x.ToString(s, iPrecision);
+    if (aPrecision <= DOUBLE_DOUBLE_BITS && in_double_range(m, e)) {
+        const DoubleDouble x = to_double_double(m, e);
+        const DoubleDouble r = dd_atan(x);
+        const double a = std::abs(x.hi);
+        if (SetDoubleDouble(r.hi, r.lo, 24 + 16 * std::abs(r.hi) + 8 * a / (1 + a * a), aPrecision))
+            return;
     }
 
-    BigNumber x(*this);
-    BigNumber y(aOther);
+    mp::ZZ a(m);
+    a.abs();
 
-    int precision = std::max(x.iPrecision, y.iPrecision);
+    const long bits = aPrecision + GUARD_BITS;
+    const long b = msb(m, e);
 
-    x.BecomeFloat(precision);
-    y.BecomeFloat(precision);
+    mp::ZZ y;
+    long p;
 
-    if (x.iNumber->iExp == y.iNumber->iExp) {
-        x.iNumber->DropTrailZeroes();
-        y.iNumber->DropTrailZeroes();
+    if (b <= 0) {
+        // ArcTan(x) is about x
+        p = bits + 16 - b;
+        y = atan_small(to_fixed(a, e, p), p);
+    } else {
+        // ArcTan(x) = Pi/2 - ArcTan(1/x)
+        p = bits + 16;
 
-        if (x.iNumber->IsZero())
-            x.iNumber->iNegative = false;
-        if (y.iNumber->IsZero())
-            y.iNumber->iNegative = false;
-        if (x.iNumber->ExactlyEqual(*y.iNumber))
-            return true;
-        if (IsInt())
-            return false;
-        if (aOther.Sign() != Sign())
-            return false;
+        mp::ZZ z;
+        long ze;
+        divide(mp::ZZ(1), 0, a, e, p, z, ze);
+
+        y = pi_fixed(p - 1);
+        y -= atan_small(to_fixed(z, ze, p), p);
     }
 
-    {
-        // TODO optimize!!!!
-        /*For tiny numbers like 1e-600, the following seemed necessary to
-    compare it with zero. if (precision< (35*-iNumber->iTensExp)/10) precision =
-    (35*-iNumber->iTensExp)/10; if (precision<
-    (35*-aOther.iNumber->iTensExp)/10) precision =
-    (35*-aOther.iNumber->iTensExp)/10;
-*/
-        BigNumber diff("0", precision);
-        BigNumber otherNeg(aOther);
-        otherNeg.Negate(aOther);
-        diff.Add(*this, otherNeg, bits_to_digits(precision, 10));
+    if (m.is_negative())
+        y.neg();
 
-        // if the numbers are float, make sure they are normalized
-        if (diff.iNumber->iExp || diff.iNumber->iTensExp) {
-            int pr = diff.iNumber->iPrecision;
-            if (pr < iPrecision)
-                pr = iPrecision;
-            if (pr < aOther.iPrecision)
-                pr = aOther.iPrecision;
-            NormalizeFloat(*diff.iNumber, WordDigits(pr, 10));
-        }
+    long ye = -p;
+    round_to(y, ye, bits);
 
-        return !Significant(*diff.iNumber);
-    }
+    SetFloat(std::move(y), ye, aPrecision);
 }
 
-bool BigNumber::IsInt() const
+// Powers with an integer exponent are exact for an integer base and are
+// otherwise found by repeated squaring; others are Exp(y Ln(x)), with the
+// logarithm taken to as many more bits as y Ln(x) has before the point.
+// As always with MathPower, 0^y = 0 and 1^y = 1.
+void BigNumber::Power(const BigNumber& aX, const BigNumber& aY, int aPrecision)
 {
-    return !!_zz;
-}
+    const mp::ZZ& m = aX.Mantissa();
+    const long e = aX.Exponent();
 
-bool BigNumber::IsSmall() const
-{
-    if (IsInt()) {
-        return _zz->no_bits() <= 53;
-        // PlatWord* ptr = &((*iNumber)[iNumber->size() - 1]);
-        // int nr = iNumber->size();
-        // while (nr > 1 && *ptr == 0) {
-        //     ptr--;
-        //     nr--;
-        // }
-        // return (nr <= iNumber->iExp + 1);
-    } else
-    // a function to test smallness of a float is not present in ANumber, need
-    // to code a workaround to determine whether a number fits into double.
-    {
-        int tensExp = iNumber->iTensExp;
-        if (tensExp < 0)
-            tensExp = -tensExp;
-        return (iNumber->iPrecision <= 53 // standard float is 53 bits
-                && tensExp < 1021 // 306  // 1021 bits is about 306 decimals
-        );
-        // standard range of double precision is about 53 bits of mantissa and
-        // binary exponent of about 1021
+    if (m.is_zero() || compare(m, e, mp::ZZ(1), 0) == 0) {
+        *this = BigNumber(mp::ZZ(m.is_zero() ? 0 : 1));
+        return;
     }
-}
 
-void BigNumber::BecomeInt()
-{
-    if (IsInt())
-        return;
+    if (aY.IsInt()) {
+        const mp::ZZ& n = *aY._zz;
 
-    while (iNumber->iTensExp > 0) {
-        BaseTimesInt(*iNumber, 10, WordBase);
-        iNumber->iTensExp--;
-    }
-    while (iNumber->iTensExp < 0) {
-        PlatDoubleWord carry = 0;
-        BaseDivideInt(*iNumber, 10, WordBase, carry);
-        iNumber->iTensExp++;
-    }
+        if (aX.IsInt() && !n.is_negative()) {
+            mp::ZZ r(*aX._zz);
 
-    iNumber->ChangePrecision(0);
+            if (compare(m, e, mp::ZZ(-1), 0) == 0) {
+                if (n.is_even())
+                    r.neg();
+            } else {
+                if (n.no_bits() > 31)
+                    throw LispErrInvalidArg();
 
-    ANumber a = *iNumber;
-    std::string s;
-    ANumberToString(s, a, 10, false);
+                r.pow(n.to_NN().to_unsigned());
+            }
 
-    _zz.reset(new mp::ZZ(s));
-    iNumber.release();
-}
+            *this = BigNumber(r);
+            return;
+        }
 
-/// Transform integer to float, setting a given bit precision.
-/// Note that aPrecision=0 means automatic setting (just enough digits to
-/// represent the integer).
-void BigNumber::BecomeFloat(int aPrecision)
-{ // FIXME: need to specify precision explicitly
-    if (!IsInt())
+        BigNumber x(aX);
+        x.BecomeFloat(aPrecision);
+        BigNumber r(mp::ZZ(1));
+        r.BecomeFloat(aPrecision);
+
+        const unsigned long k = n.no_bits();
+        for (unsigned long i = 0; i < k; ++i) {
+            if (n.test(i))
+                r.Multiply(r, x, aPrecision);
+            if (i + 1 < k)
+                x.Multiply(x, x, aPrecision);
+        }
+
+        if (n.is_negative())
+            r.Divide(BigNumber(mp::ZZ(1)), r, aPrecision);
+
+        *this = r;
+        return;
+    }
+
+    if (m.is_negative()) {
+        // a real power of a negative number needs an integer exponent
+        if (!aY.IsIntegral())
+            throw LispErrInvalidArg();
+
+        BigNumber n(aY);
+        n.BecomeInt();
+        Power(aX, n, aPrecision);
         return;
+    }
+
+    const long extra =
+        std::max(0L,
+                 msb(aY.Mantissa(), aY.Exponent()) +
+                     static_cast<long>(bit_length(std::abs(msb(m, e)) + 1))) +
+        8;
 
-    const int precision = std::max(iPrecision, aPrecision);
-    iNumber.reset(new ANumber(
-        _zz->to_string(),
-        bits_to_digits(precision, 10))); // is this OK or ChangePrecision means
-                                         // floating-point precision?
+    BigNumber l(mp::ZZ(0));
+    l.Ln(aX, aPrecision + extra);
+    l.Multiply(l, aY, aPrecision + extra);
 
-    _zz.release();
+    Exp(l, aPrecision);
 }
 
-bool BigNumber::LessThan(const BigNumber& aOther) const
+void BigNumber::Pi(int aPrecision)
 {
-    if (IsInt() && aOther.IsInt())
-        return *_zz < *aOther._zz;
+    const long bits = aPrecision + GUARD_BITS;
+
+    mp::ZZ y = pi_fixed(bits);
+    long ye = -bits;
+    round_to(y, ye, bits);
 
-    BigNumber x(*this);
-    BigNumber y(aOther);
+    SetFloat(std::move(y), ye, aPrecision);
+}
 
-    const int precision = std::max(x.iPrecision, y.iPrecision);
+void BigNumber::EulerGamma(int aPrecision)
+{
+    const long bits = aPrecision + GUARD_BITS;
 
-    x.BecomeFloat(precision);
-    y.BecomeFloat(precision);
+    mp::ZZ y = cached(euler_gamma_constant, bits);
+    long ye = -bits;
+    round_to(y, ye, bits);
 
-    ANumber a1(*x.iNumber);
-    ANumber a2(*y.iNumber);
-    return ::LessThan(a1, a2);
+    SetFloat(std::move(y), ye, aPrecision);
 }
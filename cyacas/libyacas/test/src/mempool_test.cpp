@@ -0,0 +1,155 @@
+/*
+ *
+ * This file is part of yacas.
+ * Yacas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesset General Public License as
+ * published by the Free Software Foundation, either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * Yacas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with yacas.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "yacas/mempool.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+// Abandoned slabs are shared by all pools of the same block size, so each
+// test uses a block size of its own.
+
+TEST(MemPoolTest, alloc_free)
+{
+    MemPool pool(40);
+
+    std::set<void*> blocks;
+    for (int i = 0; i < 5000; ++i) {
+        void* p = pool.alloc();
+        ASSERT_EQ(reinterpret_cast<std::uintptr_t>(p) % 8, 0u);
+        ASSERT_TRUE(blocks.insert(p).second);
+    }
+
+    MemPool::Statistics stats = pool.statistics();
+    ASSERT_EQ(stats.block_size, 40u);
+    ASSERT_EQ(stats.no_allocs, 5000u);
+    ASSERT_EQ(stats.no_used_blocks, 5000u);
+    ASSERT_GE(stats.no_blocks, 5000u);
+    ASSERT_EQ(stats.no_slabs, stats.no_slabs_allocated);
+
+    // the block freed last is handed out first
+    void* p = *blocks.begin();
+    pool.free(p);
+    ASSERT_EQ(pool.alloc(), p);
+
+    for (void* q : blocks)
+        pool.free(q);
+
+    stats = pool.statistics();
+    ASSERT_EQ(stats.no_frees, 5001u);
+    ASSERT_EQ(stats.no_used_blocks, 0u);
+}
+
+TEST(MemPoolTest, remote_free)
+{
+    MemPool pool(48);
+
+    void* first = pool.alloc();
+    const std::size_t n = pool.statistics().no_blocks;
+
+    std::vector<void*> blocks = {first};
+    for (std::size_t i = 1; i < n; ++i)
+        blocks.push_back(pool.alloc());
+
+    // freed on other threads at once, to contend for the slab's stack
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < 4; ++t)
+        threads.emplace_back([&blocks, t] {
+            MemPool local(48);
+            for (std::size_t i = t; i < blocks.size(); i += 4)
+                local.free(blocks[i]);
+        });
+    for (std::thread& t : threads)
+        t.join();
+
+    // not counted until collected
+    MemPool::Statistics stats = pool.statistics();
+    ASSERT_EQ(stats.no_frees, 0u);
+    ASSERT_EQ(stats.no_used_blocks, n);
+
+    // the slab is full, so this collects them instead of taking another
+    std::set<void*> again;
+    for (std::size_t i = 0; i < n; ++i)
+        ASSERT_TRUE(again.insert(pool.alloc()).second);
+
+    stats = pool.statistics();
+    ASSERT_EQ(stats.no_frees, n);
+    ASSERT_EQ(stats.no_slabs_allocated, 1u);
+    ASSERT_EQ(again, std::set<void*>(blocks.begin(), blocks.end()));
+
+    for (void* p : again)
+        pool.free(p);
+}
+
+namespace {
+    struct Node: FastAlloc<Node> {
+        char data[56];
+    };
+}
+
+TEST(MemPoolTest, adoption)
+{
+    std::vector<Node*> nodes;
+
+    std::thread([&nodes] {
+        for (int i = 0; i < 100; ++i)
+            nodes.push_back(new Node);
+    }).join();
+
+    // the owner has exited, leaving its slab to be adopted
+    for (std::size_t i = 0; i < 50; ++i)
+        delete nodes[i];
+
+    MemPool::Statistics stats = {};
+    std::thread([&nodes, &stats] {
+        Node* n = new Node;
+        stats = FastAlloc<Node>::statistics();
+        delete n;
+
+        for (std::size_t i = 50; i < nodes.size(); ++i)
+            delete nodes[i];
+    }).join();
+
+    ASSERT_EQ(stats.no_slabs_adopted, 1u);
+    ASSERT_EQ(stats.no_slabs_allocated, 0u);
+    // blocks freed while the slab was abandoned are nobody's frees
+    ASSERT_EQ(stats.no_frees, 0u);
+    ASSERT_EQ(stats.no_used_blocks, 51u);
+}
+
+TEST(MemPoolTest, release_empty_slabs)
+{
+    MemPool pool(64);
+
+    std::vector<void*> blocks;
+    while (pool.statistics().no_slabs < 10)
+        blocks.push_back(pool.alloc());
+
+    for (void* p : blocks)
+        pool.free(p);
+
+    const MemPool::Statistics stats = pool.statistics();
+    ASSERT_EQ(stats.no_slabs_allocated, 10u);
+    ASSERT_LE(stats.no_slabs, 4u);
+    ASSERT_EQ(stats.no_slabs_released, 10 - stats.no_slabs);
+    ASSERT_EQ(stats.no_used_blocks, 0u);
+}
@@ -39,6 +39,14 @@ std::string random_string(std::size_t length)
     return str;
 }
 
+// Operands built from random bits have the same size in both the 32-bit and
+// the 64-bit limb builds, their results are labelled with the limb width so
+// that the two builds can be compared directly.
+static std::string limb_label()
+{
+    return std::to_string(sizeof(NN::Limb) * CHAR_BIT) + "-bit limbs";
+}
+
 static void BM_NN_construct_random(benchmark::State& state)
 {
     for (auto _: state) {
@@ -69,6 +77,25 @@ static void BM_NN_to_string(benchmark::State& state)
     state.SetComplexityN(state.range());
 }
 
+// range(0) bits in base range(1)
+static void BM_NN_to_string_base(benchmark::State& state)
+{
+    const NN a(state.range(0), rng);
+    for (auto _: state)
+        a.to_string(state.range(1));
+    state.SetComplexityN(state.range(0));
+    state.SetLabel(limb_label());
+}
+
+static void BM_NN_parse_base(benchmark::State& state)
+{
+    const std::string s = NN(state.range(0), rng).to_string(state.range(1));
+    for (auto _: state)
+        NN b(s, state.range(1));
+    state.SetComplexityN(state.range(0));
+    state.SetLabel(limb_label());
+}
+
 static void BM_NN_shift_left(benchmark::State& state)
 {
     for (auto _: state) {
@@ -151,6 +178,186 @@ static void BM_NN_mul(benchmark::State& state)
     state.SetComplexityN(state.range(0) * state.range(1));
 }
 
+static void BM_NN_add_bits(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        NN a(state.range(0), rng);
+        NN b(state.range(0), rng);
+        state.ResumeTiming();
+        a += b;
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+static void BM_NN_mul_limb(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        NN a(state.range(0), rng);
+        const NN::Limb b = static_cast<NN::Limb>(rng()) | 1;
+        state.ResumeTiming();
+        a *= b;
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+static void BM_NN_div_limb(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        NN a(state.range(0), rng);
+        const NN::Limb b = static_cast<NN::Limb>(rng()) | 1;
+        state.ResumeTiming();
+        a /= b;
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+static void BM_NN_mul_balanced(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        NN a(state.range(0), rng);
+        NN b(state.range(0), rng);
+        state.ResumeTiming();
+        a *= b;
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+static void BM_NN_mul_unbalanced(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        NN a(state.range(0), rng);
+        NN b(state.range(0) / 8, rng);
+        state.ResumeTiming();
+        a *= b;
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+// range(0) bits by range(0) bits on range(1) threads; wall-clock time, so
+// that the speed-up over one thread can be read off directly, and a
+// complexity fit per number of threads
+static void BM_NN_mul_threads(benchmark::State& state)
+{
+    const unsigned threads = NN::threads();
+    const unsigned threads_threshold = NN::MUL_THREADS_THRESHOLD;
+
+    NN::set_threads(state.range(1));
+    NN::MUL_THREADS_THRESHOLD = 1;
+
+    const NN a(state.range(0), rng);
+    const NN b(state.range(0), rng);
+
+    for (auto _: state) {
+        NN c(a);
+        c *= b;
+    }
+
+    NN::set_threads(threads);
+    NN::MUL_THREADS_THRESHOLD = threads_threshold;
+
+    state.SetComplexityN(state.range(0));
+    state.SetLabel(limb_label());
+}
+
+static void BM_NN_sqr_large(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        NN a(state.range(0), rng);
+        state.ResumeTiming();
+        a.sqr();
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+static void BM_NN_div_large(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        NN a(2 * state.range(0), rng);
+        NN b(state.range(0), rng);
+        state.ResumeTiming();
+        a /= b;
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+// dividends of growing size over a divisor of fixed size
+static void BM_NN_div_unbalanced(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        NN a(state.range(0), rng);
+        NN b(state.range(1), rng);
+        b.set(state.range(1) - 1);
+        state.ResumeTiming();
+        a /= b;
+    }
+    state.SetComplexityN(state.range(0));
+    state.SetLabel(limb_label());
+}
+
+static void BM_NN_pow(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        NN a(64, rng);
+        a.set(63);
+        state.ResumeTiming();
+        a.pow(state.range(0) / 64);
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+static void BM_NN_gcd(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        NN a(state.range(0), rng);
+        NN b(state.range(0), rng);
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(gcd(a, b));
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+static void BM_NN_powmod(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        NN b(state.range(0), rng);
+        NN e(state.range(0), rng);
+        NN m(state.range(0), rng);
+        m.set(0);
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(powmod(b, e, m));
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+static void BM_NN_factorial(benchmark::State& state)
+{
+    for (auto _: state)
+        benchmark::DoNotOptimize(factorial(state.range(0)));
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
 static void BM_NN_div(benchmark::State& state)
 {
     for (auto _: state) {
@@ -168,17 +375,43 @@ static void BM_NN_div(benchmark::State& state)
 
 BENCHMARK(BM_NN_construct_random)->Range(1, 1<<16)->Complexity();
 BENCHMARK(BM_NN_parse)->Range(1, 1<<14)->Complexity();
-BENCHMARK(BM_NN_to_string)->Range(1, 1 << 16);
-BENCHMARK(BM_NN_shift_left)->Ranges({{1, 1<<8}, {1, 1<<8}});
-BENCHMARK(BM_NN_add)->Ranges({{1, 1<<8}, {1, 1<<8}});
-BENCHMARK(BM_NN_add_self)->Range(1, 16);
-BENCHMARK(BM_NN_add_self)->Range(16, 1<<10);
-BENCHMARK(BM_NN_add_same)->Range(1, 16);
-BENCHMARK(BM_NN_add_same)->Range(16, 1<<10);
-BENCHMARK(BM_NN_sqr)->Range(1, 1<<16);
-BENCHMARK(BM_NN_mul_same)->Range(1, 16);
-BENCHMARK(BM_NN_mul_same)->Range(16, 1<<10);
-BENCHMARK(BM_NN_mul)->Ranges({{1, 1<<8}, {1, 1<<8}});
-BENCHMARK(BM_NN_div)->Ranges({{1, 1<<8}, {1, 1<<8}});
+BENCHMARK(BM_NN_to_string)->Range(1, 1 << 16)->Complexity();
+BENCHMARK(BM_NN_to_string_base)->Ranges({{1<<10, 1<<20}, {2, 2}})->Complexity();
+BENCHMARK(BM_NN_to_string_base)->Ranges({{1<<10, 1<<20}, {10, 10}})->Complexity();
+BENCHMARK(BM_NN_to_string_base)->Ranges({{1<<10, 1<<20}, {16, 16}})->Complexity();
+BENCHMARK(BM_NN_parse_base)->Ranges({{1<<10, 1<<20}, {2, 2}})->Complexity();
+BENCHMARK(BM_NN_parse_base)->Ranges({{1<<10, 1<<20}, {10, 10}})->Complexity();
+BENCHMARK(BM_NN_parse_base)->Ranges({{1<<10, 1<<20}, {16, 16}})->Complexity();
+BENCHMARK(BM_NN_shift_left)->Ranges({{1, 1<<8}, {1, 1<<8}})->Complexity();
+BENCHMARK(BM_NN_add)->Ranges({{1, 1<<8}, {1, 1<<8}})->Complexity();
+BENCHMARK(BM_NN_add_self)->Range(1, 16)->Complexity();
+BENCHMARK(BM_NN_add_self)->Range(16, 1<<10)->Complexity();
+BENCHMARK(BM_NN_add_same)->Range(1, 16)->Complexity();
+BENCHMARK(BM_NN_add_same)->Range(16, 1<<10)->Complexity();
+BENCHMARK(BM_NN_sqr)->Range(1, 1<<16)->Complexity();
+BENCHMARK(BM_NN_mul_same)->Range(1, 16)->Complexity();
+BENCHMARK(BM_NN_mul_same)->Range(16, 1<<10)->Complexity();
+BENCHMARK(BM_NN_mul)->Ranges({{1, 1<<8}, {1, 1<<8}})->Complexity();
+BENCHMARK(BM_NN_add_bits)->Range(1<<10, 1<<20)->Complexity();
+BENCHMARK(BM_NN_mul_limb)->Range(1<<10, 1<<20)->Complexity();
+BENCHMARK(BM_NN_div_limb)->Range(1<<10, 1<<20)->Complexity();
+BENCHMARK(BM_NN_mul_balanced)->Range(1<<10, 1<<18)->Complexity();
+BENCHMARK(BM_NN_mul_unbalanced)->Range(1<<13, 1<<18)->Complexity();
+BENCHMARK(BM_NN_mul_balanced)->Range(1<<19, 1<<23)->Complexity(benchmark::oNLogN);
+BENCHMARK(BM_NN_mul_threads)->ArgsProduct({{1<<18, 1<<21, 1<<24}, {1}})->UseRealTime()->Complexity();
+BENCHMARK(BM_NN_mul_threads)->ArgsProduct({{1<<18, 1<<21, 1<<24}, {2}})->UseRealTime()->Complexity();
+BENCHMARK(BM_NN_mul_threads)->ArgsProduct({{1<<18, 1<<21, 1<<24}, {4}})->UseRealTime()->Complexity();
+BENCHMARK(BM_NN_mul_threads)->ArgsProduct({{1<<18, 1<<21, 1<<24}, {8}})->UseRealTime()->Complexity();
+BENCHMARK(BM_NN_mul_threads)->ArgsProduct({{1<<18, 1<<21, 1<<24}, {16}})->UseRealTime()->Complexity();
+BENCHMARK(BM_NN_mul_threads)->ArgsProduct({{1<<18, 1<<21, 1<<24}, {32}})->UseRealTime()->Complexity();
+BENCHMARK(BM_NN_sqr_large)->Range(1<<16, 1<<23)->Complexity(benchmark::oNLogN);
+BENCHMARK(BM_NN_div)->Ranges({{1, 1<<8}, {1, 1<<8}})->Complexity();
+BENCHMARK(BM_NN_div_large)->Range(1<<10, 1<<20)->Complexity();
+BENCHMARK(BM_NN_div_unbalanced)->Ranges({{1<<12, 1<<20}, {1<<6, 1<<6}})->Complexity();
+BENCHMARK(BM_NN_div_unbalanced)->Ranges({{1<<12, 1<<20}, {1<<10, 1<<10}})->Complexity();
+BENCHMARK(BM_NN_pow)->Range(1<<8, 1<<20)->Complexity();
+BENCHMARK(BM_NN_gcd)->Range(1<<10, 1<<20)->Complexity();
+BENCHMARK(BM_NN_powmod)->Range(1<<6, 1<<14)->Complexity();
+BENCHMARK(BM_NN_factorial)->Range(1<<8, 1<<18)->Complexity();
 
 BENCHMARK_MAIN();
@@ -0,0 +1,184 @@
+/*
+ *
+ * This file is part of yacas.
+ * Yacas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesset General Public License as
+ * published by the Free Software Foundation, either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * Yacas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with yacas.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "yacas/mp/zz.hpp"
+
+#include <benchmark/benchmark.h>
+
+std::mt19937_64 rng;
+
+using namespace yacas::mp;
+
+static std::string limb_label()
+{
+    return std::to_string(sizeof(NN::Limb) * CHAR_BIT) + "-bit limbs";
+}
+
+// a random nonzero number of the given size, negative if neg is set
+static ZZ random_zz(unsigned no_bits, bool neg)
+{
+    ZZ a(no_bits, rng);
+    if (a.is_zero())
+        a = ZZ::ONE;
+    if (neg)
+        a.neg();
+    return a;
+}
+
+// operands of opposite signs, so that the magnitudes are subtracted
+static void BM_ZZ_add(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        ZZ a = random_zz(state.range(0), false);
+        ZZ b = random_zz(state.range(0), true);
+        state.ResumeTiming();
+        a += b;
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+static void BM_ZZ_sub(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        ZZ a = random_zz(state.range(0), true);
+        ZZ b = random_zz(state.range(0), false);
+        state.ResumeTiming();
+        a -= b;
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+static void BM_ZZ_add_int(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        ZZ a = random_zz(state.range(0), true);
+        state.ResumeTiming();
+        a += 12345;
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+static void BM_ZZ_mul(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        ZZ a = random_zz(state.range(0), true);
+        ZZ b = random_zz(state.range(0), false);
+        state.ResumeTiming();
+        a *= b;
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+static void BM_ZZ_div(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        ZZ a = random_zz(2 * state.range(0), true);
+        ZZ b = random_zz(state.range(0), false);
+        state.ResumeTiming();
+        a /= b;
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+static void BM_ZZ_rem(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        ZZ a = random_zz(2 * state.range(0), true);
+        ZZ b = random_zz(state.range(0), true);
+        state.ResumeTiming();
+        a %= b;
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+static void BM_ZZ_gcd(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        ZZ a = random_zz(state.range(0), true);
+        ZZ b = random_zz(state.range(0), false);
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(gcd(a, b));
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+static void BM_ZZ_xgcd(benchmark::State& state)
+{
+    ZZ s, t;
+    for (auto _: state) {
+        state.PauseTiming();
+        ZZ a = random_zz(state.range(0), true);
+        ZZ b = random_zz(state.range(0), false);
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(xgcd(a, b, s, t));
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+// a 64-bit base raised to the given size of the result
+static void BM_ZZ_pow(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        ZZ a = random_zz(64, true);
+        state.ResumeTiming();
+        a.pow(state.range(0) / 64);
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+static void BM_ZZ_to_string(benchmark::State& state)
+{
+    for (auto _: state) {
+        state.PauseTiming();
+        const ZZ a = random_zz(state.range(0), true);
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(a.to_string());
+    }
+    state.SetComplexityN(state.range());
+    state.SetLabel(limb_label());
+}
+
+BENCHMARK(BM_ZZ_add)->Range(1<<6, 1<<20)->Complexity();
+BENCHMARK(BM_ZZ_sub)->Range(1<<6, 1<<20)->Complexity();
+BENCHMARK(BM_ZZ_add_int)->Range(1<<6, 1<<20)->Complexity();
+BENCHMARK(BM_ZZ_mul)->Range(1<<6, 1<<20)->Complexity();
+BENCHMARK(BM_ZZ_div)->Range(1<<6, 1<<18)->Complexity();
+BENCHMARK(BM_ZZ_rem)->Range(1<<6, 1<<18)->Complexity();
+BENCHMARK(BM_ZZ_gcd)->Range(1<<6, 1<<18)->Complexity();
+BENCHMARK(BM_ZZ_xgcd)->Range(1<<6, 1<<16)->Complexity();
+BENCHMARK(BM_ZZ_pow)->Range(1<<8, 1<<20)->Complexity();
+BENCHMARK(BM_ZZ_to_string)->Range(1<<6, 1<<18)->Complexity();
+
+BENCHMARK_MAIN();
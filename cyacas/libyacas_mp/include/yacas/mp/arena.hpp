@@ -0,0 +1,133 @@
+/*
+ *
+ * This file is part of yacas.
+ * Yacas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesset General Public License as
+ * published by the Free Software Foundation, either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * Yacas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with yacas.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef YACAS_MP_ARENA_HPP
+#define YACAS_MP_ARENA_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace yacas {
+    namespace mp {
+        // Scratch memory for the temporaries of the arithmetic algorithms.
+        // Memory is handed out by bumping a pointer and taken back in bulk
+        // when the innermost Mark goes out of scope, so that once the arena
+        // has grown to the working size of an algorithm, the algorithm
+        // allocates nothing from the heap however deep it recurses.
+        class Arena {
+        public:
+            // Everything allocated while a Mark is alive is released when
+            // it is destroyed. Marks nest and must be destroyed in reverse
+            // order of their creation.
+            class Mark {
+            public:
+                Mark();
+                explicit Mark(Arena&);
+                ~Mark();
+
+                Mark(const Mark&) = delete;
+                Mark& operator=(const Mark&) = delete;
+
+            private:
+                Arena& _arena;
+                std::size_t _block;
+                std::size_t _used;
+            };
+
+            Arena() = default;
+            ~Arena();
+
+            Arena(const Arena&) = delete;
+            Arena& operator=(const Arena&) = delete;
+
+            // the arena of the calling thread
+            static Arena& local();
+
+            // uninitialised room for n objects, valid until the innermost
+            // Mark is destroyed
+            template <typename T> T* alloc(std::size_t n);
+
+            // bytes held, used or not
+            std::size_t capacity() const;
+
+        private:
+            struct Block {
+                char* data;
+                std::size_t size;
+            };
+
+            // the first block, enough for the temporaries of most
+            // multiplications below the FFT threshold
+            static constexpr std::size_t MIN_BLOCK_SIZE = 64 * 1024;
+
+            // memory kept for reuse when the outermost Mark goes away
+            static constexpr std::size_t MAX_RETAINED_SIZE = 16 * 1024 * 1024;
+
+            std::vector<Block> _blocks;
+            std::size_t _block = 0;
+            std::size_t _used = 0;
+            unsigned _marks = 0;
+
+            void* alloc_bytes(std::size_t n);
+            void* alloc_block(std::size_t n);
+            void release(std::size_t block, std::size_t used);
+        };
+
+        template <typename T> inline T* Arena::alloc(std::size_t n)
+        {
+            static_assert(std::is_trivially_copyable<T>::value,
+                          "Arena holds trivially copyable types only");
+            static_assert(alignof(T) <= alignof(std::max_align_t),
+                          "Arena does not support over-aligned types");
+
+            return static_cast<T*>(alloc_bytes(n * sizeof(T)));
+        }
+
+        inline void* Arena::alloc_bytes(std::size_t n)
+        {
+            assert(_marks > 0);
+
+            constexpr std::size_t a = alignof(std::max_align_t);
+            n = (n + a - 1) & ~(a - 1);
+
+            if (_block < _blocks.size() && _blocks[_block].size - _used >= n) {
+                void* p = _blocks[_block].data + _used;
+                _used += n;
+                return p;
+            }
+
+            return alloc_block(n);
+        }
+
+        inline Arena::Mark::Mark() : Mark(Arena::local()) {}
+
+        inline Arena::Mark::Mark(Arena& arena) :
+            _arena(arena),
+            _block(arena._block),
+            _used(arena._used)
+        {
+            _arena._marks += 1;
+        }
+
+        inline Arena::Mark::~Mark() { _arena.release(_block, _used); }
+    }
+}
+
+#endif
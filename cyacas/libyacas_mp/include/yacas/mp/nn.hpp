@@ -29,12 +29,27 @@
 #include <string_view>
 #include <vector>
 
+#include "small_vector.hpp"
+
+#if defined(YACAS_MP_LIMB64) && !defined(__SIZEOF_INT128__)
+#error "64-bit limbs require a compiler supporting unsigned __int128"
+#endif
+
 namespace yacas {
     namespace mp {
         class NN {
         public:
+#ifdef YACAS_MP_LIMB64
+            typedef std::uint64_t Limb;
+            __extension__ typedef unsigned __int128 Limb2;
+#else
             typedef std::uint32_t Limb;
             typedef std::uint64_t Limb2;
+#endif
+
+            // limbs of the number, least significant first; two limbs are
+            // kept inline, so small numbers need no heap allocation
+            typedef SmallVector<Limb, 2> Limbs;
 
             static const NN ZERO;
             static const NN ONE;
@@ -44,9 +59,32 @@ namespace yacas {
             static unsigned PARSE_DC_THRESHOLD;
             static unsigned TO_STRING_DC_THRESHOLD;
             static unsigned DIV_REM_DC_THRESHOLD;
+            static unsigned GCD_DC_THRESHOLD;
+            static unsigned HGCD_THRESHOLD;
+            static unsigned POWMOD_REDC_THRESHOLD;
+            static unsigned FACTORIAL_SWING_THRESHOLD;
 
             static unsigned MUL_TOOM22_THRESHOLD;
             static unsigned MUL_TOOM33_THRESHOLD;
+            static unsigned MUL_FFT_THRESHOLD;
+            static unsigned MUL_THREADS_THRESHOLD;
+
+            // The thresholds above as NAME = value lines, # starting a
+            // comment. Unknown names, malformed lines and thresholds
+            // written for a different LIMB_BITS make loading throw
+            // std::invalid_argument. On startup the thresholds are loaded
+            // from the file named by the environment variable
+            // YACAS_MP_THRESHOLDS, if set; mp_tune writes such files.
+            static void load_thresholds(std::istream&);
+            static void save_thresholds(std::ostream&);
+
+            // The number of threads the products of operands of at least
+            // MUL_THREADS_THRESHOLD limbs are spread over, 1 by default or
+            // the value of the environment variable YACAS_MP_THREADS.
+            // Changing it waits for the products using the threads to
+            // finish.
+            static void set_threads(unsigned n);
+            static unsigned threads();
 
             struct ParseError : public std::invalid_argument {
                 ParseError(std::string_view s, std::size_t) :
@@ -116,6 +154,24 @@ namespace yacas {
             void sqr();
             void pow(unsigned);
 
+            // floor(sqrt(*this)) and floor(*this^(1/k)) for k > 0
+            void isqrt();
+            void iroot(unsigned k);
+
+            // whether *this = r^k for some k > 1; r and the largest such k
+            // are returned, or *this and 1 if there is none, as for 0 and 1
+            bool is_perfect_power(NN& r, unsigned& k) const;
+            bool is_perfect_power() const;
+
+            // *this <- *this + a * b, without a temporary for the product
+            // when a or b fits in a limb
+            void addmul(const NN& a, const NN& b);
+            // *this <- |*this - a * b|; returns whether a * b was larger
+            bool submul(const NN& a, const NN& b);
+            // *this <- *this / d for d known to divide *this; faster than
+            // the general division, the result is unspecified otherwise
+            void divexact(const NN& d);
+
             unsigned long no_bits() const;
             unsigned long no_digits() const;
 
@@ -123,7 +179,13 @@ namespace yacas {
             void set(unsigned long bit);
             void clear(unsigned long bit);
 
-            const std::vector<Limb>& limbs() const;
+            // the number modulo 2^n
+            NN low_bits(unsigned long n) const;
+
+            // a copy of the limbs, as the std::vector it has always been
+            std::vector<Limb> limbs() const;
+            // the limbs themselves
+            const Limbs& raw_limbs() const;
 
         private:
             static constexpr int LIMB_BITS = sizeof(Limb) * CHAR_BIT;
@@ -133,8 +195,6 @@ namespace yacas {
 
             static constexpr Limb2 BASE = static_cast<Limb2>(LIMB_MAX) + 1;
 
-            typedef std::vector<Limb> Limbs;
-
             Limbs _limbs;
 
             template <typename Iter> NN(Iter b, Iter e)
@@ -145,6 +205,9 @@ namespace yacas {
 
             void drop_zeros();
 
+            static int clz(Limb);
+            static int ctz(Limb);
+
             void add(Limb);
             void sub(Limb);
             void mul(Limb);
@@ -162,29 +225,51 @@ namespace yacas {
             void rem(const NN&);
             NN div_rem(const NN&);
 
-            void sqr_bc();
-            void sqr_toom22();
-            void sqr_toom33();
+            NN div_rem_bc(const NN&);
+            NN div_rem_dc(const NN&);
 
-            void mul_bc(const NN&);
-            void mul_toom22(const NN&);
-            void mul_toom33(const NN&);
+            static void div_2n1n(NN a, const NN& b, unsigned long n, NN& q, NN& r);
+            static void div_3n2n(const NN& a12, const NN& a3, const NN& b,
+                                 const NN& b1, const NN& b2, unsigned long n,
+                                 NN& q, NN& r);
 
-            NN div_rem_bc(const NN&);
+            // b^(2^i), computed once per thread
+            static const NN& radix_power(unsigned b, unsigned i);
+
+            void parse_bc(const char* s, std::size_t n, unsigned b);
+            void parse_dc(const char* s, std::size_t n, unsigned b);
+            void parse_pow2(const char* s, std::size_t n, unsigned k);
 
             std::string to_string_bc(unsigned base = 10) const;
-            std::string to_string_dc(unsigned base = 10) const;
+            std::string to_string_pow2(unsigned k) const;
+            void to_string_dc(unsigned base, std::string& s, std::size_t width) const;
         };
 
         NN gcd(NN a, NN b);
 
+        // b^e mod m
+        NN powmod(const NN& b, const NN& e, const NN& m);
+
+        // n!
+        NN factorial(NN::Limb n);
+
+        // n!! = n (n - 2) (n - 4) ..., 1 for n = 0
+        NN double_factorial(NN::Limb n);
+
+        // n choose k
+        NN binomial(const NN& n, NN::Limb k);
+
+        // a (a + 1) ... b, 1 for a > b; b - a has to fit in a limb
+        NN partial_factorial(const NN& a, const NN& b);
+
         inline NN::NN(Limb n)
         {
             if (n != 0)
                 _limbs.push_back(n);
         }
 
-        inline NN::NN(const std::vector<Limb>& limbs) : _limbs(limbs)
+        inline NN::NN(const std::vector<Limb>& limbs) :
+            _limbs(limbs.data(), limbs.data() + limbs.size())
         {
             drop_zeros();
         }
@@ -216,17 +301,20 @@ namespace yacas {
 
         inline bool NN::operator==(Limb n) const
         {
+            if (_limbs.empty())
+                return n == 0;
+
             return _limbs.size() == 1 && _limbs.front() == n;
         }
 
-        inline bool NN::operator!=(Limb n) const
-        {
-            return _limbs.size() != 1 || _limbs.front() != n;
-        }
+        inline bool NN::operator!=(Limb n) const { return !(*this == n); }
 
         inline bool NN::operator<(Limb n) const
         {
-            return _limbs.empty() || (_limbs.size() == 1 && _limbs.front() < n);
+            if (_limbs.empty())
+                return n != 0;
+
+            return _limbs.size() == 1 && _limbs.front() < n;
         }
 
         inline bool NN::operator>(Limb n) const
@@ -403,13 +491,7 @@ namespace yacas {
             if (is_zero())
                 return 1;
 
-#ifdef _MSC_VER
-            unsigned long index = 0;
-            _BitScanReverse(&index, _limbs.back());
-            return _limbs.size() * LIMB_BITS - (31 - index);
-#else
-            return _limbs.size() * LIMB_BITS - __builtin_clz(_limbs.back());
-#endif
+            return _limbs.size() * LIMB_BITS - clz(_limbs.back());
         }
 
         inline unsigned long NN::no_digits() const
@@ -428,19 +510,49 @@ namespace yacas {
         inline bool NN::test(unsigned long bit) const
         {
             assert(bit < _limbs.size() * LIMB_BITS);
-            return _limbs[bit / LIMB_BITS] & (1 << (bit % LIMB_BITS));
+            return _limbs[bit / LIMB_BITS] &
+                   (static_cast<Limb>(1) << (bit % LIMB_BITS));
         }
 
         inline void NN::set(unsigned long bit)
         {
             assert(bit < _limbs.size() * LIMB_BITS);
-            _limbs[bit / LIMB_BITS] |= (1 << (bit % LIMB_BITS));
+            _limbs[bit / LIMB_BITS] |= static_cast<Limb>(1) << (bit % LIMB_BITS);
         }
 
         inline void NN::clear(unsigned long bit)
         {
             assert(bit < _limbs.size() * LIMB_BITS);
-            _limbs[bit / LIMB_BITS] &= ~(1 << (bit % LIMB_BITS));
+            _limbs[bit / LIMB_BITS] &=
+                ~(static_cast<Limb>(1) << (bit % LIMB_BITS));
+        }
+
+        inline int NN::clz(Limb x)
+        {
+            assert(x != 0);
+#ifdef _MSC_VER
+            unsigned long index = 0;
+            _BitScanReverse(&index, x);
+            return LIMB_BITS - 1 - index;
+#elif defined(YACAS_MP_LIMB64)
+            return __builtin_clzll(x);
+#else
+            return __builtin_clz(x);
+#endif
+        }
+
+        inline int NN::ctz(Limb x)
+        {
+            assert(x != 0);
+#ifdef _MSC_VER
+            unsigned long index = 0;
+            _BitScanForward(&index, x);
+            return index;
+#elif defined(YACAS_MP_LIMB64)
+            return __builtin_ctzll(x);
+#else
+            return __builtin_ctz(x);
+#endif
         }
 
         inline bool NN::is_zero() const { return _limbs.empty(); }
@@ -469,7 +581,12 @@ namespace yacas {
                 _limbs.pop_back();
         }
 
-        inline const std::vector<NN::Limb>& NN::limbs() const { return _limbs; }
+        inline std::vector<NN::Limb> NN::limbs() const
+        {
+            return std::vector<Limb>(_limbs.begin(), _limbs.end());
+        }
+
+        inline const NN::Limbs& NN::raw_limbs() const { return _limbs; }
 
         inline ::std::ostream& operator<<(::std::ostream& os, const NN& n)
         {
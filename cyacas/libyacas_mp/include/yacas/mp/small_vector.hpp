@@ -0,0 +1,367 @@
+/*
+ *
+ * This file is part of yacas.
+ * Yacas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesset General Public License as
+ * published by the Free Software Foundation, either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * Yacas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with yacas.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef YACAS_MP_SMALL_VECTOR_HPP
+#define YACAS_MP_SMALL_VECTOR_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+
+namespace yacas {
+    namespace mp {
+        // Subset of std::vector for trivially copyable types, keeping up to
+        // N elements inside the object itself; the heap is used only when
+        // the size grows beyond that.
+        template <typename T, unsigned N> class SmallVector {
+            static_assert(std::is_trivially_copyable<T>::value,
+                          "SmallVector requires a trivially copyable type");
+
+        public:
+            typedef T value_type;
+            typedef std::size_t size_type;
+            typedef T& reference;
+            typedef const T& const_reference;
+            typedef T* iterator;
+            typedef const T* const_iterator;
+            typedef std::reverse_iterator<iterator> reverse_iterator;
+            typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+            SmallVector() noexcept;
+            explicit SmallVector(size_type n, const T& v = T());
+            SmallVector(const T* b, const T* e);
+            SmallVector(std::initializer_list<T>);
+            SmallVector(const SmallVector&);
+            SmallVector(SmallVector&&) noexcept;
+
+            ~SmallVector();
+
+            SmallVector& operator=(const SmallVector&);
+            SmallVector& operator=(SmallVector&&) noexcept;
+            SmallVector& operator=(std::initializer_list<T>);
+
+            bool operator==(const SmallVector&) const;
+            bool operator!=(const SmallVector&) const;
+
+            bool empty() const { return _size == 0; }
+            size_type size() const { return _size; }
+            size_type capacity() const { return _capacity; }
+
+            T* data() { return _data; }
+            const T* data() const { return _data; }
+
+            T& operator[](size_type i) { return _data[i]; }
+            const T& operator[](size_type i) const { return _data[i]; }
+
+            T& front() { return _data[0]; }
+            const T& front() const { return _data[0]; }
+            T& back() { return _data[_size - 1]; }
+            const T& back() const { return _data[_size - 1]; }
+
+            iterator begin() { return _data; }
+            const_iterator begin() const { return _data; }
+            iterator end() { return _data + _size; }
+            const_iterator end() const { return _data + _size; }
+
+            reverse_iterator rbegin() { return reverse_iterator(end()); }
+            const_reverse_iterator rbegin() const
+            {
+                return const_reverse_iterator(end());
+            }
+            reverse_iterator rend() { return reverse_iterator(begin()); }
+            const_reverse_iterator rend() const
+            {
+                return const_reverse_iterator(begin());
+            }
+
+            void reserve(size_type n);
+            void resize(size_type n, const T& v = T());
+            void clear() { _size = 0; }
+
+            void push_back(const T& v);
+            void pop_back() { _size -= 1; }
+
+            void assign(size_type n, const T& v);
+            void assign(const T* b, const T* e);
+
+            iterator insert(const_iterator p, size_type n, const T& v);
+            iterator insert(const_iterator p, const T* b, const T* e);
+
+            iterator erase(const_iterator b, const_iterator e);
+
+            void swap(SmallVector&) noexcept;
+
+        private:
+            T* _data;
+            unsigned _size;
+            unsigned _capacity;
+            T _inline[N];
+
+            bool is_inline() const { return _data == _inline; }
+
+            void release();
+
+            // makes room for at least n elements, keeping the contents
+            void grow(size_type n);
+        };
+
+        template <typename T, unsigned N>
+        inline SmallVector<T, N>::SmallVector() noexcept :
+            _data(_inline),
+            _size(0),
+            _capacity(N)
+        {
+        }
+
+        template <typename T, unsigned N>
+        inline SmallVector<T, N>::SmallVector(size_type n, const T& v) :
+            SmallVector()
+        {
+            assign(n, v);
+        }
+
+        template <typename T, unsigned N>
+        inline SmallVector<T, N>::SmallVector(const T* b, const T* e) :
+            SmallVector()
+        {
+            assign(b, e);
+        }
+
+        template <typename T, unsigned N>
+        inline SmallVector<T, N>::SmallVector(std::initializer_list<T> l) :
+            SmallVector()
+        {
+            assign(l.begin(), l.end());
+        }
+
+        template <typename T, unsigned N>
+        inline SmallVector<T, N>::SmallVector(const SmallVector& v) :
+            SmallVector()
+        {
+            assign(v.begin(), v.end());
+        }
+
+        template <typename T, unsigned N>
+        inline SmallVector<T, N>::SmallVector(SmallVector&& v) noexcept :
+            SmallVector()
+        {
+            swap(v);
+        }
+
+        template <typename T, unsigned N>
+        inline SmallVector<T, N>::~SmallVector()
+        {
+            release();
+        }
+
+        template <typename T, unsigned N>
+        inline SmallVector<T, N>& SmallVector<T, N>::
+        operator=(const SmallVector& v)
+        {
+            if (this != &v)
+                assign(v.begin(), v.end());
+
+            return *this;
+        }
+
+        template <typename T, unsigned N>
+        inline SmallVector<T, N>& SmallVector<T, N>::
+        operator=(SmallVector&& v) noexcept
+        {
+            if (this != &v) {
+                clear();
+                swap(v);
+            }
+
+            return *this;
+        }
+
+        template <typename T, unsigned N>
+        inline SmallVector<T, N>& SmallVector<T, N>::
+        operator=(std::initializer_list<T> l)
+        {
+            assign(l.begin(), l.end());
+            return *this;
+        }
+
+        template <typename T, unsigned N>
+        inline bool SmallVector<T, N>::operator==(const SmallVector& v) const
+        {
+            return _size == v._size && std::equal(begin(), end(), v.begin());
+        }
+
+        template <typename T, unsigned N>
+        inline bool SmallVector<T, N>::operator!=(const SmallVector& v) const
+        {
+            return !(*this == v);
+        }
+
+        template <typename T, unsigned N>
+        inline void SmallVector<T, N>::reserve(size_type n)
+        {
+            if (n > _capacity)
+                grow(n);
+        }
+
+        template <typename T, unsigned N>
+        inline void SmallVector<T, N>::resize(size_type n, const T& v)
+        {
+            reserve(n);
+
+            if (n > _size)
+                std::fill(_data + _size, _data + n, v);
+
+            _size = n;
+        }
+
+        template <typename T, unsigned N>
+        inline void SmallVector<T, N>::push_back(const T& v)
+        {
+            if (_size == _capacity) {
+                // v may refer to an element of this vector
+                const T t = v;
+                grow(_size + 1);
+                _data[_size++] = t;
+            } else {
+                _data[_size++] = v;
+            }
+        }
+
+        template <typename T, unsigned N>
+        inline void SmallVector<T, N>::assign(size_type n, const T& v)
+        {
+            const T t = v;
+            clear();
+            reserve(n);
+            std::fill(_data, _data + n, t);
+            _size = n;
+        }
+
+        template <typename T, unsigned N>
+        inline void SmallVector<T, N>::assign(const T* b, const T* e)
+        {
+            assert(b == e || b < _data || b >= _data + _capacity);
+
+            const size_type n = e - b;
+            clear();
+            reserve(n);
+            if (n)
+                std::memcpy(_data, b, n * sizeof(T));
+            _size = n;
+        }
+
+        template <typename T, unsigned N>
+        typename SmallVector<T, N>::iterator
+        SmallVector<T, N>::insert(const_iterator p, size_type n, const T& v)
+        {
+            const size_type i = p - _data;
+            const T t = v;
+
+            reserve(_size + n);
+            std::memmove(_data + i + n, _data + i, (_size - i) * sizeof(T));
+            std::fill(_data + i, _data + i + n, t);
+            _size += n;
+
+            return _data + i;
+        }
+
+        template <typename T, unsigned N>
+        typename SmallVector<T, N>::iterator
+        SmallVector<T, N>::insert(const_iterator p, const T* b, const T* e)
+        {
+            assert(b == e || b < _data || b >= _data + _capacity);
+
+            const size_type i = p - _data;
+            const size_type n = e - b;
+
+            reserve(_size + n);
+            std::memmove(_data + i + n, _data + i, (_size - i) * sizeof(T));
+            if (n)
+                std::memcpy(_data + i, b, n * sizeof(T));
+            _size += n;
+
+            return _data + i;
+        }
+
+        template <typename T, unsigned N>
+        inline typename SmallVector<T, N>::iterator
+        SmallVector<T, N>::erase(const_iterator b, const_iterator e)
+        {
+            const size_type i = b - _data;
+            const size_type n = e - b;
+
+            std::memmove(_data + i, e, (end() - e) * sizeof(T));
+            _size -= n;
+
+            return _data + i;
+        }
+
+        template <typename T, unsigned N>
+        void SmallVector<T, N>::swap(SmallVector& v) noexcept
+        {
+            if (!is_inline() && !v.is_inline()) {
+                std::swap(_data, v._data);
+            } else if (is_inline() && v.is_inline()) {
+                // only the elements in use; the rest may never have been set
+                T t[N];
+                std::memcpy(t, _inline, _size * sizeof(T));
+                std::memcpy(_inline, v._inline, v._size * sizeof(T));
+                std::memcpy(v._inline, t, _size * sizeof(T));
+            } else {
+                SmallVector& s = is_inline() ? *this : v;
+                SmallVector& h = is_inline() ? v : *this;
+
+                std::memcpy(h._inline, s._inline, s._size * sizeof(T));
+                s._data = h._data;
+                h._data = h._inline;
+            }
+
+            std::swap(_size, v._size);
+            std::swap(_capacity, v._capacity);
+        }
+
+        template <typename T, unsigned N>
+        inline void SmallVector<T, N>::release()
+        {
+            if (!is_inline())
+                ::operator delete(_data);
+        }
+
+        template <typename T, unsigned N>
+        void SmallVector<T, N>::grow(size_type n)
+        {
+            const size_type c = std::max<size_type>(n, 2 * _capacity);
+
+            T* p = static_cast<T*>(::operator new(c * sizeof(T)));
+            if (_size)
+                std::memcpy(p, _data, _size * sizeof(T));
+
+            release();
+
+            _data = p;
+            _capacity = c;
+        }
+    }
+}
+
+#endif
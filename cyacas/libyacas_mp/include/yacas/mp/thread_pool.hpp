@@ -0,0 +1,187 @@
+/*
+ *
+ * This file is part of yacas.
+ * Yacas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesset General Public License as
+ * published by the Free Software Foundation, either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * Yacas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with yacas.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef YACAS_MP_THREAD_POOL_HPP
+#define YACAS_MP_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace yacas {
+    namespace mp {
+        // Fork-join parallelism for the divide and conquer algorithms. Every
+        // thread has a queue of the tasks it has forked, which it works off
+        // from the back, while idle threads steal from the front of the
+        // queues of the others. A thread waiting for a forked task runs
+        // queued tasks in the meantime, so tasks may fork and wait in turn
+        // without tying up threads, and sleeps when there are none.
+        class ThreadPool {
+        public:
+            // n threads, the one calling invoke() included
+            explicit ThreadPool(unsigned n);
+            ~ThreadPool();
+
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            unsigned size() const;
+
+            // Calls all the functions, the first in the calling thread and
+            // the others wherever there is a thread to spare, and returns
+            // when they are done. The first exception thrown, if any, is
+            // rethrown once all of them have finished.
+            template <typename F, typename... Fs> void invoke(F&& f, Fs&&... fs);
+
+            // f(b, e) over a partition of [begin, end) into ranges of no
+            // more than grain elements
+            template <typename F>
+            void for_range(std::size_t begin, std::size_t end, std::size_t grain, F&& f);
+
+        private:
+            class Task {
+            public:
+                template <typename F> explicit Task(F& f);
+
+                Task(const Task&) = delete;
+                Task& operator=(const Task&) = delete;
+
+                void run() noexcept;
+                bool done() const;
+                std::exception_ptr error() const;
+
+            private:
+                void* _f;
+                void (*_call)(void*);
+                std::exception_ptr _error;
+                std::atomic<bool> _done;
+            };
+
+            struct Queue {
+                std::mutex mutex;
+                std::deque<Task*> tasks;
+            };
+
+            // queue 0 is shared by the threads outside the pool
+            std::unique_ptr<Queue[]> _queues;
+            std::vector<std::thread> _workers;
+
+            // idle workers and threads waiting for a task sleep on _wake;
+            // _waiting counts the latter
+            std::atomic<unsigned> _queued;
+            std::mutex _mutex;
+            std::condition_variable _wake;
+            unsigned _waiting;
+            bool _stop;
+
+            unsigned index() const;
+
+            void push(Task*);
+            Task* pop();
+            void run(Task*);
+            void wait(Task&);
+            void work(unsigned);
+        };
+
+        template <typename F>
+        inline ThreadPool::Task::Task(F& f) :
+            _f(std::addressof(f)),
+            _call([](void* p) { (*static_cast<F*>(p))(); }),
+            _done(false)
+        {
+        }
+
+        inline void ThreadPool::Task::run() noexcept
+        {
+            try {
+                _call(_f);
+            } catch (...) {
+                _error = std::current_exception();
+            }
+
+            _done.store(true, std::memory_order_release);
+        }
+
+        inline bool ThreadPool::Task::done() const
+        {
+            return _done.load(std::memory_order_acquire);
+        }
+
+        inline std::exception_ptr ThreadPool::Task::error() const
+        {
+            return _error;
+        }
+
+        template <typename F, typename... Fs>
+        inline void ThreadPool::invoke(F&& f, Fs&&... fs)
+        {
+            if constexpr (sizeof...(Fs) == 0) {
+                f();
+            } else {
+                Task tasks[] = {Task(fs)...};
+
+                for (Task& t : tasks)
+                    push(&t);
+
+                std::exception_ptr error;
+
+                try {
+                    f();
+                } catch (...) {
+                    error = std::current_exception();
+                }
+
+                // the last one pushed is the first one found in the own queue
+                for (std::size_t i = sizeof...(Fs); i-- > 0;) {
+                    wait(tasks[i]);
+                    if (!error)
+                        error = tasks[i].error();
+                }
+
+                if (error)
+                    std::rethrow_exception(error);
+            }
+        }
+
+        template <typename F>
+        inline void ThreadPool::for_range(std::size_t begin,
+                                          std::size_t end,
+                                          std::size_t grain,
+                                          F&& f)
+        {
+            if (end - begin <= grain) {
+                if (begin != end)
+                    f(begin, end);
+                return;
+            }
+
+            const std::size_t middle = begin + (end - begin) / 2;
+
+            invoke([&] { for_range(begin, middle, grain, f); },
+                   [&] { for_range(middle, end, grain, f); });
+        }
+    }
+}
+
+#endif
@@ -93,6 +93,8 @@ namespace yacas {
             void clear();
 
             const NN& to_NN() const;
+            // |*this|, without copying it
+            const NN& magnitude() const;
 
             int to_int() const;
             std::string to_string(unsigned base = 10) const;
@@ -103,6 +105,12 @@ namespace yacas {
             void sqr();
             void pow(unsigned);
 
+            // *this <- *this + a * b and *this <- *this - a * b in place
+            void addmul(const ZZ& a, const ZZ& b);
+            void submul(const ZZ& a, const ZZ& b);
+            // *this <- *this / d for d known to divide *this
+            void divexact(const ZZ& d);
+
             unsigned long no_bits() const;
             unsigned long no_digits() const;
 
@@ -123,6 +131,15 @@ namespace yacas {
             return ZZ(gcd(a.to_NN(), b.to_NN()));
         }
 
+        // returns g = gcd(a, b) and sets s and t such that s * a + t * b = g
+        ZZ xgcd(const ZZ& a, const ZZ& b, ZZ& s, ZZ& t);
+
+        // b^e mod m for m > 0 and e >= 0; the result lies in [0, m)
+        ZZ powmod(const ZZ& b, const ZZ& e, const ZZ& m);
+
+        // a (a + 1) ... b, 1 for a > b; b - a has to fit in a limb
+        ZZ partial_factorial(const ZZ& a, const ZZ& b);
+
         inline ZZ::ZZ() : _neg(false) {}
 
         inline ZZ::ZZ(int i) : _nn(std::abs(i)), _neg(i < 0) {}
@@ -467,6 +484,42 @@ namespace yacas {
             _nn.pow(n);
         }
 
+        inline void ZZ::addmul(const ZZ& a, const ZZ& b)
+        {
+            if (_neg == (a._neg != b._neg))
+                _nn.addmul(a._nn, b._nn);
+            else if (_nn.submul(a._nn, b._nn))
+                _neg = !_neg;
+
+            if (_nn.is_zero())
+                _neg = false;
+        }
+
+        inline void ZZ::submul(const ZZ& a, const ZZ& b)
+        {
+            if (_neg != (a._neg != b._neg))
+                _nn.addmul(a._nn, b._nn);
+            else if (_nn.submul(a._nn, b._nn))
+                _neg = !_neg;
+
+            if (_nn.is_zero())
+                _neg = false;
+        }
+
+        inline void ZZ::divexact(const ZZ& d)
+        {
+            if (d.is_zero())
+                throw DivisionByZeroError(to_string());
+
+            if (d._neg)
+                _neg = !_neg;
+
+            _nn.divexact(d._nn);
+
+            if (_nn.is_zero())
+                _neg = false;
+        }
+
         inline unsigned long ZZ::no_bits() const { return _nn.no_bits(); }
 
         inline unsigned long ZZ::no_digits() const { return _nn.no_digits(); }
@@ -510,6 +563,11 @@ namespace yacas {
             return _nn;
         }
 
+        inline const NN& ZZ::magnitude() const
+        {
+            return _nn;
+        }
+
         inline int ZZ::to_int() const
         {
             return (is_negative() ? -1 : 1) *
@@ -0,0 +1,101 @@
+/*
+ *
+ * This file is part of yacas.
+ * Yacas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesset General Public License as
+ * published by the Free Software Foundation, either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * Yacas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with yacas.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "yacas/mp/arena.hpp"
+
+#include <algorithm>
+#include <new>
+
+namespace yacas {
+    namespace mp {
+        Arena::~Arena()
+        {
+            assert(_marks == 0);
+
+            for (const Block& b : _blocks)
+                ::operator delete(b.data);
+        }
+
+        Arena& Arena::local()
+        {
+            static thread_local Arena arena;
+            return arena;
+        }
+
+        std::size_t Arena::capacity() const
+        {
+            std::size_t c = 0;
+            for (const Block& b : _blocks)
+                c += b.size;
+            return c;
+        }
+
+        // The current block is full; move on to the next one that is large
+        // enough, or add a new one. Blocks skipped over stay unused until
+        // the enclosing Mark goes away.
+        void* Arena::alloc_block(std::size_t n)
+        {
+            std::size_t i = _blocks.empty() ? 0 : _block + 1;
+
+            while (i < _blocks.size() && _blocks[i].size < n)
+                ++i;
+
+            if (i == _blocks.size()) {
+                const std::size_t size = std::max(
+                    {n, MIN_BLOCK_SIZE, _blocks.empty() ? 0 : 2 * _blocks.back().size});
+
+                _blocks.push_back({static_cast<char*>(::operator new(size)), size});
+            }
+
+            _block = i;
+            _used = n;
+
+            return _blocks[i].data;
+        }
+
+        void Arena::release(std::size_t block, std::size_t used)
+        {
+            assert(_marks > 0);
+
+            _block = block;
+            _used = used;
+
+            if (--_marks > 0)
+                return;
+
+            const std::size_t size = capacity();
+
+            if (_blocks.size() < 2 && size <= MAX_RETAINED_SIZE)
+                return;
+
+            // The outermost Mark is gone and the arena had to grow while it
+            // was alive; replace the blocks by a single one of the total
+            // size, so that the next time around it is enough on its own.
+            // Very large blocks are not kept, though.
+            for (const Block& b : _blocks)
+                ::operator delete(b.data);
+            _blocks.clear();
+
+            const std::size_t retained = std::min(size, MAX_RETAINED_SIZE);
+            _blocks.push_back({static_cast<char*>(::operator new(retained)), retained});
+
+            _block = 0;
+            _used = 0;
+        }
+    }
+}
@@ -0,0 +1,339 @@
+/*
+ *
+ * This file is part of yacas.
+ * Yacas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesset General Public License as
+ * published by the Free Software Foundation, either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * Yacas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with yacas.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "yacas/mp/zz.hpp"
+
+#include <climits>
+#include <vector>
+
+// Factorials, binomials and products of integer ranges.
+//
+// All of them multiply many small factors; the factors are packed into
+// limbs and the limbs are multiplied as a balanced product tree, so that
+// the large multiplications are done on operands of similar size where
+// the subquadratic algorithms pay off.
+//
+// Large factorials use the prime swing recursion n! = (n/2)!^2 swing(n),
+// where swing(n) is assembled from its prime factorisation; binomials with
+// both arguments large are assembled from their prime factorisation too.
+
+namespace {
+    using namespace yacas::mp;
+
+    typedef NN::Limb Limb;
+    typedef NN::Limb2 Limb2;
+
+    static constexpr int LIMB_BITS = sizeof(Limb) * CHAR_BIT;
+
+    // below that many limbs the product is accumulated sequentially
+    static constexpr std::size_t PRODUCT_TREE_LEAF = 16;
+
+    // n choose k is assembled from primes when k is at least
+    // BINOMIAL_PRIMES_K and n / k at most BINOMIAL_PRIMES_RATIO
+    static constexpr Limb BINOMIAL_PRIMES_K = 1024;
+    static constexpr Limb BINOMIAL_PRIMES_RATIO = 256;
+
+    NN tree_product(const Limb* b, const Limb* e)
+    {
+        if (static_cast<std::size_t>(e - b) <= PRODUCT_TREE_LEAF) {
+            NN r(NN::ONE);
+            for (; b != e; ++b)
+                r *= *b;
+            return r;
+        }
+
+        const Limb* m = b + (e - b) / 2;
+
+        NN r = tree_product(b, m);
+        r *= tree_product(m, e);
+
+        return r;
+    }
+
+    // collects factors, packing as many as fit into each limb
+    class Factors {
+    public:
+        void push(Limb x)
+        {
+            const Limb2 p = static_cast<Limb2>(_acc) * x;
+
+            if (p >> LIMB_BITS) {
+                _f.push_back(_acc);
+                _acc = x;
+            } else {
+                _acc = static_cast<Limb>(p);
+            }
+        }
+
+        NN product()
+        {
+            if (_acc != 1)
+                _f.push_back(_acc);
+            _acc = 1;
+
+            return tree_product(_f.data(), _f.data() + _f.size());
+        }
+
+    private:
+        std::vector<Limb> _f;
+        Limb _acc = 1;
+    };
+
+    // product of the odd numbers in (a, b]
+    NN odd_product(Limb a, Limb b)
+    {
+        Factors f;
+        for (Limb i = (a + 1) | 1; i <= b && i != 0; i += 2)
+            f.push(i);
+
+        return f.product();
+    }
+
+    // a (a + 1) ... (a + n - 1)
+    NN range_product(const NN& a, Limb n)
+    {
+        if (n <= PRODUCT_TREE_LEAF) {
+            NN r(NN::ONE);
+            NN t(a);
+            for (Limb i = 0; i < n; ++i) {
+                r *= t;
+                t += 1;
+            }
+            return r;
+        }
+
+        const Limb h = n / 2;
+
+        NN m(a);
+        m += h;
+
+        NN r = range_product(a, h);
+        r *= range_product(m, n - h);
+
+        return r;
+    }
+
+    // primes up to n
+    std::vector<Limb> primes(Limb n)
+    {
+        std::vector<Limb> p;
+
+        if (n < 2)
+            return p;
+
+        p.push_back(2);
+
+        // odd numbers only, i stands for 2 i + 1
+        std::vector<bool> composite(n / 2 + 1);
+        for (Limb i = 1; 2 * i + 1 <= n; ++i) {
+            if (composite[i])
+                continue;
+
+            const Limb q = 2 * i + 1;
+            p.push_back(q);
+
+            if (q <= n / q)
+                for (Limb j = q * q / 2; j <= n / 2; j += q)
+                    composite[j] = true;
+        }
+
+        return p;
+    }
+
+    // n! = 2^(n - popcount(n)) prod_i o(n / 2^i), o(m) being the product
+    // of the odd numbers up to m
+    NN factorial_bc(Limb n)
+    {
+        NN p(NN::ONE);
+        NN r(NN::ONE);
+
+        unsigned long popcount = 0;
+        for (Limb m = n; m; m >>= 1)
+            popcount += m & 1;
+
+        for (int i = LIMB_BITS - 1; i >= 0; --i) {
+            const Limb hi = n >> i;
+            if (hi < 3)
+                continue;
+
+            p *= odd_product(hi >> 1, hi);
+            r *= p;
+        }
+
+        r <<= n - popcount;
+
+        return r;
+    }
+
+    // n! / (n/2)!^2 from its prime factorisation
+    NN swing(Limb n, const std::vector<Limb>& primes)
+    {
+        Factors f;
+
+        for (Limb p : primes) {
+            if (p > n)
+                break;
+
+            // p^e does not exceed n
+            Limb pe = 1;
+            for (Limb q = n / p; q; q /= p)
+                if (q & 1)
+                    pe *= p;
+
+            if (pe > 1)
+                f.push(pe);
+        }
+
+        return f.product();
+    }
+
+    NN factorial_swing(Limb n, const std::vector<Limb>& primes)
+    {
+        if (n < NN::FACTORIAL_SWING_THRESHOLD)
+            return factorial_bc(n);
+
+        NN r = factorial_swing(n / 2, primes);
+        r.sqr();
+        r *= swing(n, primes);
+
+        return r;
+    }
+
+    // n choose k from its prime factorisation, k <= n / 2
+    NN binomial_primes(Limb n, Limb k)
+    {
+        Factors f;
+
+        for (Limb p : primes(n)) {
+            // p^e, e the number of borrows subtracting k from n in base p,
+            // does not exceed n
+            Limb pe = 1;
+            for (Limb a = n, b = k, c = n - k; a; a /= p, b /= p, c /= p)
+                if (a / p - b / p - c / p)
+                    pe *= p;
+
+            if (pe > 1)
+                f.push(pe);
+        }
+
+        return f.product();
+    }
+}
+
+namespace yacas {
+    namespace mp {
+        NN factorial(NN::Limb n)
+        {
+            if (n < NN::FACTORIAL_SWING_THRESHOLD)
+                return factorial_bc(n);
+
+            return factorial_swing(n, primes(n));
+        }
+
+        NN double_factorial(NN::Limb n)
+        {
+            if (n & 1)
+                return odd_product(0, n);
+
+            NN r = factorial(n / 2);
+            r <<= n / 2;
+
+            return r;
+        }
+
+        NN binomial(const NN& n, NN::Limb k)
+        {
+            if (n < k)
+                return NN::ZERO;
+
+            if (n.raw_limbs().size() == 1) {
+                const Limb m = n.raw_limbs().front();
+
+                k = std::min(k, m - k);
+
+                if (k >= BINOMIAL_PRIMES_K && m / k <= BINOMIAL_PRIMES_RATIO)
+                    return binomial_primes(m, k);
+            }
+
+            NN a(n);
+            a -= k;
+            a += 1;
+
+            NN r = partial_factorial(a, n);
+            r /= factorial(k);
+
+            return r;
+        }
+
+        NN partial_factorial(const NN& a, const NN& b)
+        {
+            if (a > b)
+                return NN::ONE;
+
+            if (a.is_zero())
+                return NN::ZERO;
+
+            NN n(b);
+            n -= a;
+
+            assert(n.raw_limbs().size() <= 1);
+
+            const Limb m = n.is_zero() ? 0 : n.raw_limbs().front();
+
+            if (b.raw_limbs().size() == 1) {
+                const Limb hi = b.raw_limbs().front();
+
+                Factors f;
+                for (Limb i = hi - m; i < hi; ++i)
+                    f.push(i);
+                f.push(hi);
+
+                return f.product();
+            }
+
+            return range_product(a, m + 1);
+        }
+
+        ZZ partial_factorial(const ZZ& a, const ZZ& b)
+        {
+            if (a > b)
+                return ZZ(1);
+
+            if (!a.is_positive() && !b.is_negative())
+                return ZZ(0);
+
+            if (a.is_positive())
+                return ZZ(partial_factorial(a.to_NN(), b.to_NN()));
+
+            ZZ c(a);
+            c.abs();
+            ZZ d(b);
+            d.abs();
+
+            ZZ r(partial_factorial(d.to_NN(), c.to_NN()));
+
+            // the number of factors, b - a + 1, decides the sign
+            ZZ n(b);
+            n -= a;
+            if (n.is_even())
+                r.neg();
+
+            return r;
+        }
+    }
+}
@@ -0,0 +1,479 @@
+/*
+ *
+ * This file is part of yacas.
+ * Yacas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesset General Public License as
+ * published by the Free Software Foundation, either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * Yacas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with yacas.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "yacas/mp/zz.hpp"
+
+#include <algorithm>
+
+// Subquadratic gcd following N. Moller, "On Schonhage's algorithm and
+// subquadratic integer gcd computation", Math. Comp. 77 (2008).
+//
+// All reductions are of the form a -= q * b (or b -= q * a), so the
+// accumulated transformation M satisfies (a0, b0) = M (a, b), has
+// nonnegative entries and determinant 1, and its inverse is known in closed
+// form. Every matrix produced from truncated operands is applied only after
+// checking that the result is still valid, so correctness never depends on
+// the truncation lemmas; they only make the checks succeed.
+
+namespace {
+    using namespace yacas::mp;
+
+    typedef NN::Limb Limb;
+    typedef NN::Limb2 Limb2;
+
+    static constexpr int LIMB_BITS = sizeof(Limb) * CHAR_BIT;
+    static constexpr unsigned LIMB2_BITS = sizeof(Limb2) * CHAR_BIT;
+
+    NN product(const NN& a, const NN& b)
+    {
+        NN r = a;
+        r *= b;
+        return r;
+    }
+
+    // a += q * b
+    void addmul(NN& a, const NN& q, const NN& b)
+    {
+        if (!b.is_zero())
+            a += product(q, b);
+    }
+
+    struct Matrix {
+        NN m00 = NN::ONE;
+        NN m01;
+        NN m10;
+        NN m11 = NN::ONE;
+
+        bool is_identity() const
+        {
+            return m01.is_zero() && m10.is_zero();
+        }
+
+        // this = this * m
+        void mul(const Matrix& m)
+        {
+            NN t00 = product(m00, m.m00);
+            addmul(t00, m01, m.m10);
+            NN t01 = product(m00, m.m01);
+            addmul(t01, m01, m.m11);
+            NN t10 = product(m10, m.m00);
+            addmul(t10, m11, m.m10);
+            NN t11 = product(m10, m.m01);
+            addmul(t11, m11, m.m11);
+
+            m00 = std::move(t00);
+            m01 = std::move(t01);
+            m10 = std::move(t10);
+            m11 = std::move(t11);
+        }
+    };
+
+    NN to_NN(Limb2 v)
+    {
+        NN r(static_cast<Limb>(v >> LIMB_BITS));
+        r <<= LIMB_BITS;
+        r += static_cast<Limb>(v);
+        return r;
+    }
+
+    // a >> p, which is required to fit in a Limb2
+    Limb2 bits_from(const NN& a, unsigned long p)
+    {
+        const NN::Limbs& l = a.raw_limbs();
+        const std::size_t i = p / LIMB_BITS;
+        const int r = p % LIMB_BITS;
+
+        Limb2 x = 0;
+        for (std::size_t k = 0; k < 3 && i + k < l.size(); ++k) {
+            const int sh = static_cast<int>(k * LIMB_BITS) - r;
+            const Limb2 v = l[i + k];
+            if (sh < 0)
+                x |= v >> -sh;
+            else if (sh < static_cast<int>(LIMB2_BITS))
+                x |= v << sh;
+        }
+
+        return x;
+    }
+
+    unsigned long max_bits(const NN& a, const NN& b)
+    {
+        return std::max(a.no_bits(), b.no_bits());
+    }
+
+    // (a, b) = M^-1 (a, b), provided both results are at least s; returns
+    // false and leaves a and b untouched otherwise
+    bool apply_inverse(const Matrix& m, NN& a, NN& b, const NN& s)
+    {
+        NN a1 = product(a, m.m11);
+        const NN t = product(b, m.m01);
+        if (a1 < t)
+            return false;
+        a1 -= t;
+        if (a1 < s)
+            return false;
+
+        NN b1 = product(b, m.m00);
+        const NN u = product(a, m.m10);
+        if (b1 < u)
+            return false;
+        b1 -= u;
+        if (b1 < s)
+            return false;
+
+        a = std::move(a1);
+        b = std::move(b1);
+
+        return true;
+    }
+
+    // single reduction step of (a, b) with respect to s, both a and b are
+    // kept at least s; returns false if (a, b) is already reduced, that is
+    // if |a - b| < s
+    bool hgcd_step(NN& a, NN& b, const NN& s, Matrix* m)
+    {
+        const bool swap = a < b;
+        NN& x = swap ? b : a;
+        NN& y = swap ? a : b;
+
+        NN q = x;
+        q -= y;
+        if (q < s)
+            return false;
+
+        q = x;
+        q -= s;
+        q /= y;
+        x -= product(q, y);
+
+        if (m) {
+            if (swap) {
+                addmul(m->m00, q, m->m01);
+                addmul(m->m10, q, m->m11);
+            } else {
+                addmul(m->m01, q, m->m00);
+                addmul(m->m11, q, m->m10);
+            }
+        }
+
+        return true;
+    }
+
+    // hgcd_step on double limbs; m receives {m00, m01, m10, m11}
+    void hgcd_word(Limb2 a, Limb2 b, unsigned s, Limb2 m[4])
+    {
+        m[0] = 1;
+        m[1] = 0;
+        m[2] = 0;
+        m[3] = 1;
+
+        const Limb2 S = static_cast<Limb2>(1) << s;
+
+        for (;;) {
+            if (a > b) {
+                if (a - b < S)
+                    break;
+                const Limb2 q = (a - S) / b;
+                a -= q * b;
+                m[1] += q * m[0];
+                m[3] += q * m[2];
+            } else {
+                if (b - a < S)
+                    break;
+                const Limb2 q = (b - S) / a;
+                b -= q * a;
+                m[0] += q * m[1];
+                m[2] += q * m[3];
+            }
+        }
+    }
+
+    // Lehmer step: reduces (a, b) with respect to s using their leading
+    // double limbs only; returns false if that gives no progress
+    bool lehmer_step(NN& a, NN& b, unsigned long s, const NN& S, Matrix* m)
+    {
+        const unsigned long n = max_bits(a, b);
+        const unsigned long p = n > LIMB2_BITS ? n - LIMB2_BITS : 0;
+        const unsigned long w = n - p;
+        const unsigned long sw = std::max(w / 2 + 1, s > p ? s - p : 0);
+
+        if (sw + 1 >= w)
+            return false;
+
+        const Limb2 ah = bits_from(a, p);
+        const Limb2 bh = bits_from(b, p);
+
+        const Limb2 SW = static_cast<Limb2>(1) << sw;
+        if (ah < SW || bh < SW)
+            return false;
+
+        Limb2 mw[4];
+        hgcd_word(ah, bh, sw, mw);
+
+        if (mw[1] == 0 && mw[2] == 0)
+            return false;
+
+        Matrix mm;
+        mm.m00 = to_NN(mw[0]);
+        mm.m01 = to_NN(mw[1]);
+        mm.m10 = to_NN(mw[2]);
+        mm.m11 = to_NN(mw[3]);
+
+        if (!apply_inverse(mm, a, b, S))
+            return false;
+
+        if (m)
+            m->mul(mm);
+
+        return true;
+    }
+
+    void hgcd_base(NN& a, NN& b, unsigned long s, const NN& S, Matrix& m)
+    {
+        for (;;)
+            if (!lehmer_step(a, b, s, S, &m) && !hgcd_step(a, b, S, &m))
+                break;
+    }
+
+    void hgcd(NN& a, NN& b, Matrix& m);
+
+    // hgcd of the bits of (a, b) above p, applied to (a, b) provided both
+    // stay at least s; the reduced high parts are reused, so only the low
+    // parts need to be multiplied by the matrix
+    bool hgcd_high(NN& a, NN& b, unsigned long p, const NN& s, Matrix& m)
+    {
+        NN ah = a;
+        NN bh = b;
+        ah >>= p;
+        bh >>= p;
+
+        NN al = a;
+        NN t = ah;
+        t <<= p;
+        al -= t;
+        NN bl = b;
+        t = bh;
+        t <<= p;
+        bl -= t;
+
+        hgcd(ah, bh, m);
+
+        if (m.is_identity())
+            return false;
+
+        ah <<= p;
+        ah += product(al, m.m11);
+        t = product(bl, m.m01);
+        if (ah < t)
+            return false;
+        ah -= t;
+        if (ah < s)
+            return false;
+
+        bh <<= p;
+        bh += product(bl, m.m00);
+        t = product(al, m.m10);
+        if (bh < t)
+            return false;
+        bh -= t;
+        if (bh < s)
+            return false;
+
+        a = std::move(ah);
+        b = std::move(bh);
+
+        return true;
+    }
+
+    // reduces (a, b) with respect to 2^(n/2+1), n being the bit length of
+    // the larger operand, and stores the transformation in m
+    void hgcd(NN& a, NN& b, Matrix& m)
+    {
+        m = Matrix();
+
+        const unsigned long n = max_bits(a, b);
+        const unsigned long s = n / 2 + 1;
+
+        NN S(NN::ONE);
+        S <<= s;
+
+        if (a < S || b < S)
+            return;
+
+        if (n < NN::HGCD_THRESHOLD * LIMB_BITS) {
+            hgcd_base(a, b, s, S, m);
+            return;
+        }
+
+        {
+            Matrix m1;
+            if (hgcd_high(a, b, n / 2, S, m1))
+                m = std::move(m1);
+        }
+
+        for (;;) {
+            if (max_bits(a, b) <= 3 * n / 4 + 1)
+                break;
+            if (!hgcd_step(a, b, S, &m))
+                return;
+        }
+
+        const unsigned long n2 = max_bits(a, b);
+        if (n2 > s + 1) {
+            Matrix m2;
+            if (hgcd_high(a, b, 2 * s + 1 - n2, S, m2))
+                m.mul(m2);
+        }
+
+        hgcd_base(a, b, s, S, m);
+    }
+
+    // Euclidean step a %= b tracked in m
+    void euclid_step(NN& a, NN& b, Matrix* m)
+    {
+        const bool swap = a < b;
+        NN& x = swap ? b : a;
+        NN& y = swap ? a : b;
+
+        if (!m) {
+            x %= y;
+            return;
+        }
+
+        NN q = x;
+        q /= y;
+        x -= product(q, y);
+
+        if (swap) {
+            addmul(m->m00, q, m->m01);
+            addmul(m->m10, q, m->m11);
+        } else {
+            addmul(m->m01, q, m->m00);
+            addmul(m->m11, q, m->m10);
+        }
+    }
+
+    Limb2 gcd_word(Limb2 a, Limb2 b)
+    {
+        while (b) {
+            const Limb2 t = a % b;
+            a = b;
+            b = t;
+        }
+
+        return a;
+    }
+
+    // reduces (a, b) to (g, 0) or (0, g), accumulating the transformation in
+    // m when given
+    void gcd_reduce(NN& a, NN& b, Matrix* m)
+    {
+        while (!a.is_zero() && !b.is_zero()) {
+            if (!m && max_bits(a, b) <= LIMB2_BITS) {
+                a = to_NN(gcd_word(bits_from(a, 0), bits_from(b, 0)));
+                b.clear();
+                break;
+            }
+
+            if (std::min(a.raw_limbs().size(), b.raw_limbs().size()) >=
+                NN::GCD_DC_THRESHOLD) {
+                NN a1 = a;
+                NN b1 = b;
+                Matrix h;
+                hgcd(a1, b1, h);
+                if (!h.is_identity()) {
+                    a = std::move(a1);
+                    b = std::move(b1);
+                    if (m)
+                        m->mul(h);
+                    continue;
+                }
+            } else if (lehmer_step(a, b, 0, NN::ZERO, m)) {
+                continue;
+            }
+
+            euclid_step(a, b, m);
+        }
+    }
+}
+
+namespace yacas {
+    namespace mp {
+        NN gcd(NN a, NN b)
+        {
+            gcd_reduce(a, b, nullptr);
+
+            return a.is_zero() ? b : a;
+        }
+
+        ZZ xgcd(const ZZ& a, const ZZ& b, ZZ& s, ZZ& t)
+        {
+            ZZ abs_a = a;
+            ZZ abs_b = b;
+            abs_a.abs();
+            abs_b.abs();
+
+            const NN& A = abs_a.to_NN();
+            const NN& B = abs_b.to_NN();
+
+            NN x = A;
+            NN y = B;
+            Matrix m;
+            gcd_reduce(x, y, &m);
+
+            // with M^-1 = {{m11, -m01}, {-m10, m00}} either
+            // g = m11 A - m01 B or g = m00 B - m10 A
+            const bool first = y.is_zero();
+            const ZZ g(first ? x : y);
+
+            s = ZZ(first ? m.m11 : m.m10);
+            if (!first)
+                s.neg();
+
+            // pick the cofactor of the smallest magnitude, which is also the
+            // one returned by the classical Euclidean algorithm
+            if (!g.is_zero() && !B.is_zero()) {
+                ZZ bg(B);
+                bg /= g;
+
+                s %= bg;
+                if (s.is_negative())
+                    s += bg;
+
+                ZZ s2 = s;
+                s2 <<= 1;
+                if (s2 > bg)
+                    s -= bg;
+            }
+
+            ZZ sa(A);
+            sa *= s;
+            t = g;
+            t -= sa;
+            if (!B.is_zero())
+                t /= ZZ(B);
+
+            if (a.is_negative())
+                s.neg();
+            if (b.is_negative())
+                t.neg();
+
+            return g;
+        }
+    }
+}
@@ -17,8 +17,17 @@
  */
 
 #include "yacas/mp/nn.hpp"
+#include "yacas/mp/arena.hpp"
+#include "yacas/mp/thread_pool.hpp"
 
 #include <cctype>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <shared_mutex>
+#include <sstream>
 
 namespace {
     using namespace yacas::mp;
@@ -28,68 +37,667 @@ namespace {
 
     static constexpr int LIMB_BITS = sizeof(Limb) * CHAR_BIT;
 
-    void _mul(const Limb* __restrict p, unsigned n, Limb a, Limb* __restrict r)
+    // Arithmetic on limb arrays of given lengths, least significant limb
+    // first, leading zeros allowed. Carries and borrows out of the top limb
+    // are returned. A result may coincide with an operand, but must not
+    // overlap it partly.
+
+    // r <- a + b, all of n limbs
+    Limb add_n(Limb* r, const Limb* a, const Limb* b, unsigned n)
+    {
+        Limb c = 0;
+
+        for (unsigned i = 0; i < n; ++i) {
+            const Limb2 v = static_cast<Limb2>(a[i]) + b[i] + c;
+            r[i] = static_cast<Limb>(v);
+            c = static_cast<Limb>(v >> LIMB_BITS);
+        }
+
+        return c;
+    }
+
+    // r <- a - b, all of n limbs
+    Limb sub_n(Limb* r, const Limb* a, const Limb* b, unsigned n)
+    {
+        Limb c = 0;
+
+        for (unsigned i = 0; i < n; ++i) {
+            const Limb2 v = static_cast<Limb2>(a[i]) - b[i] - c;
+            r[i] = static_cast<Limb>(v);
+            c = (v >> LIMB_BITS) != 0;
+        }
+
+        return c;
+    }
+
+    // r <- a + c, both of n limbs
+    Limb add_1(Limb* r, const Limb* a, unsigned n, Limb c)
+    {
+        unsigned i = 0;
+
+        for (; i < n && c; ++i) {
+            r[i] = a[i] + c;
+            c = r[i] < c;
+        }
+
+        if (r != a)
+            std::copy(a + i, a + n, r + i);
+
+        return c;
+    }
+
+    // r <- a - c, both of n limbs
+    Limb sub_1(Limb* r, const Limb* a, unsigned n, Limb c)
+    {
+        unsigned i = 0;
+
+        for (; i < n && c; ++i) {
+            const Limb v = a[i];
+            r[i] = v - c;
+            c = v < c;
+        }
+
+        if (r != a)
+            std::copy(a + i, a + n, r + i);
+
+        return c;
+    }
+
+    // r <- a + b, a and r of m limbs, b of n <= m limbs
+    Limb add_mn(Limb* r, const Limb* a, unsigned m, const Limb* b, unsigned n)
+    {
+        return add_1(r + n, a + n, m - n, add_n(r, a, b, n));
+    }
+
+    // r <- a - b, a and r of m limbs, b of n <= m limbs
+    Limb sub_mn(Limb* r, const Limb* a, unsigned m, const Limb* b, unsigned n)
+    {
+        return sub_1(r + n, a + n, m - n, sub_n(r, a, b, n));
+    }
+
+    int cmp_n(const Limb* a, const Limb* b, unsigned n)
+    {
+        while (n--)
+            if (a[n] != b[n])
+                return a[n] < b[n] ? -1 : 1;
+
+        return 0;
+    }
+
+    // r <- |a - b|, a of m limbs, b of n limbs, r of max(m, n) limbs;
+    // returns whether a - b is negative (arbitrary if it is zero)
+    bool abs_sub(Limb* r, const Limb* a, unsigned m, const Limb* b, unsigned n)
+    {
+        const bool swapped = m < n;
+        if (swapped) {
+            std::swap(a, b);
+            std::swap(m, n);
+        }
+
+        const bool less = std::all_of(a + n, a + m, [](Limb l) { return l == 0; }) &&
+                          cmp_n(a, b, n) < 0;
+
+        if (less) {
+            sub_n(r, b, a, n);
+            std::fill(r + n, r + m, 0);
+        } else {
+            sub_mn(r, a, m, b, n);
+        }
+
+        return less != swapped;
+    }
+
+    // a <- a << 1, n limbs, returns the bit shifted out
+    Limb lshift1(Limb* a, unsigned n)
+    {
+        Limb c = 0;
+
+        for (unsigned i = 0; i < n; ++i) {
+            const Limb t = a[i];
+            a[i] = (t << 1) | c;
+            c = t >> (LIMB_BITS - 1);
+        }
+
+        return c;
+    }
+
+    // a <- a >> 1, n limbs
+    void rshift1(Limb* a, unsigned n)
+    {
+        for (unsigned i = 0; i + 1 < n; ++i)
+            a[i] = (a[i] >> 1) | (a[i + 1] << (LIMB_BITS - 1));
+
+        a[n - 1] >>= 1;
+    }
+
+    // r <- a << k, n limbs, 0 <= k < LIMB_BITS, returns the bits shifted out
+    Limb lshift(Limb* r, const Limb* a, unsigned n, unsigned k)
+    {
+        if (k == 0) {
+            std::copy(a, a + n, r);
+            return 0;
+        }
+
+        const Limb c = a[n - 1] >> (LIMB_BITS - k);
+
+        for (unsigned i = n - 1; i > 0; --i)
+            r[i] = (a[i] << k) | (a[i - 1] >> (LIMB_BITS - k));
+
+        r[0] = a[0] << k;
+
+        return c;
+    }
+
+    // r <- a >> k, n limbs, 0 <= k < LIMB_BITS
+    void rshift(Limb* r, const Limb* a, unsigned n, unsigned k)
+    {
+        if (k == 0) {
+            std::copy(a, a + n, r);
+            return;
+        }
+
+        for (unsigned i = 0; i + 1 < n; ++i)
+            r[i] = (a[i] >> k) | (a[i + 1] << (LIMB_BITS - k));
+
+        r[n - 1] = a[n - 1] >> k;
+    }
+
+    // a <- a / 3 for a divisible by 3, n limbs
+    void divexact_by3(Limb* a, unsigned n)
+    {
+        Limb2 t = 0;
+
+        for (unsigned i = n; i-- > 0;) {
+            t = (t << LIMB_BITS) | a[i];
+            a[i] = static_cast<Limb>(t / 3);
+            t %= 3;
+        }
+
+        assert(t == 0);
+    }
+
+    // r <- a * b, n limbs, returns the carry limb
+    Limb mul_1(Limb* r, const Limb* a, unsigned n, Limb b)
+    {
+        Limb c = 0;
+
+        for (unsigned i = 0; i < n; ++i) {
+            const Limb2 v = static_cast<Limb2>(a[i]) * b + c;
+            r[i] = static_cast<Limb>(v);
+            c = static_cast<Limb>(v >> LIMB_BITS);
+        }
+
+        return c;
+    }
+
+    // r <- r + a * b, n limbs, returns the carry limb
+    Limb addmul_1(Limb* __restrict r, const Limb* __restrict a, unsigned n, Limb b)
+    {
+        Limb c = 0;
+
+        for (unsigned i = 0; i < n; ++i) {
+            const Limb2 v = static_cast<Limb2>(a[i]) * b + r[i] + c;
+            r[i] = static_cast<Limb>(v);
+            c = static_cast<Limb>(v >> LIMB_BITS);
+        }
+
+        return c;
+    }
+
+    // r <- r - a * b, n limbs, returns the borrow limb
+    Limb submul_1(Limb* __restrict r, const Limb* __restrict a, unsigned n, Limb b)
+    {
+        Limb c = 0;
+
+        for (unsigned i = 0; i < n; ++i) {
+            const Limb2 p = static_cast<Limb2>(a[i]) * b + c;
+            const Limb l = static_cast<Limb>(p);
+            c = static_cast<Limb>(p >> LIMB_BITS) + (r[i] < l);
+            r[i] -= l;
+        }
+
+        return c;
+    }
+
+    // a <- B^n - a, n limbs, a nonzero
+    void neg_n(Limb* a, unsigned n)
+    {
+        for (unsigned i = 0; i < n; ++i)
+            a[i] = ~a[i];
+
+        add_1(a, a, n, 1);
+    }
+
+    // the inverse of an odd limb modulo B; every Newton step doubles the
+    // number of correct bits, and a is its own inverse modulo 8
+    Limb inverse_1(Limb a)
+    {
+        assert(a & 1);
+
+        Limb x = a;
+        for (int bits = 3; bits < LIMB_BITS; bits *= 2)
+            x *= 2 - a * x;
+
+        return x;
+    }
+
+    // q <- a / b for b odd dividing a exactly (Hensel division); a of
+    // qn limbs is destroyed, b has n limbs, only the low qn limbs of the
+    // partial remainders are computed
+    void divexact_bc(Limb* q, Limb* a, unsigned qn, const Limb* b, unsigned n)
+    {
+        const Limb inv = inverse_1(b[0]);
+
+        for (unsigned i = 0; i < qn; ++i) {
+            q[i] = a[i] * inv;
+
+            const unsigned l = std::min(n, qn - i);
+            const Limb c = submul_1(a + i, b, l, q[i]);
+            sub_1(a + i + l, a + i + l, qn - i - l, c);
+        }
+    }
+
+    // Products. r <- a * b for a of m limbs and b of n limbs, m >= n >= 1,
+    // into the m + n limbs of r, which must not overlap the operands.
+    // Temporaries are taken from the arena. The partial products of
+    // operands of at least MUL_THREADS_THRESHOLD limbs are computed in
+    // parallel, if there is a pool; every task uses the arena of the
+    // thread that runs it.
+
+    // NN::set_threads() replaces the pool only while no product is
+    // using it
+    std::shared_mutex pool_mutex;
+    std::unique_ptr<ThreadPool> pool;
+
+    // Keeps the pool in place for a product with an operand of n limbs,
+    // unless it is too small to use the pool at all.
+    class PoolLock {
+    public:
+        explicit PoolLock(unsigned n) : _lock(pool_mutex, std::defer_lock)
+        {
+            if (n >= NN::MUL_THREADS_THRESHOLD)
+                _lock.lock();
+        }
+
+    private:
+        std::shared_lock<std::shared_mutex> _lock;
+    };
+
+    // the pool the products of n limb operands are spread over, if any
+    ThreadPool* parallel(unsigned n)
+    {
+        return n >= NN::MUL_THREADS_THRESHOLD ? pool.get() : nullptr;
+    }
+
+    template <typename... Fs> void fork(ThreadPool* tp, Fs&&... fs)
+    {
+        if (tp)
+            tp->invoke(fs...);
+        else
+            (fs(), ...);
+    }
+
+    // f(b, e) over ranges covering [0, n), cost the work per element in
+    // simple loop iterations
+    template <typename F>
+    void split(ThreadPool* tp, std::size_t n, F&& f, std::size_t cost = 1)
+    {
+        const std::size_t min_grain = std::max<std::size_t>((1 << 14) / cost, 1);
+
+        if (tp && n > min_grain)
+            tp->for_range(0, n, std::max(min_grain, n / (4 * tp->size())), f);
+        else
+            f(0, n);
+    }
+
+    void mul_mn(Limb* r, const Limb* a, unsigned m, const Limb* b, unsigned n, Arena&);
+    void sqr_n(Limb* r, const Limb* a, unsigned n, Arena&);
+
+    void mul_basecase(Limb* r, const Limb* a, unsigned m, const Limb* b, unsigned n)
+    {
+        r[m] = mul_1(r, a, m, b[0]);
+
+        for (unsigned i = 1; i < n; ++i)
+            r[m + i] = addmul_1(r + i, a, m, b[i]);
+    }
+
+    // the products a[i] a[j] for i < j are computed once and doubled
+    void sqr_basecase(Limb* r, const Limb* a, unsigned n)
     {
         if (n == 1) {
-            const Limb2 v = static_cast<Limb2>(*p) * a;
+            const Limb2 v = static_cast<Limb2>(a[0]) * a[0];
             r[0] = static_cast<Limb>(v);
             r[1] = static_cast<Limb>(v >> LIMB_BITS);
             return;
         }
 
-        Limb carry = 0;
-
-        for (unsigned j = 0; j < n; ++j) {
-            const Limb2 v = static_cast<Limb2>(*p++) * a + carry;
-            carry = static_cast<Limb>(v >> LIMB_BITS);
-            *r += static_cast<Limb>(v);
-            carry += *r++ < static_cast<Limb>(v);
+        r[0] = 0;
+        r[n] = mul_1(r + 1, a + 1, n - 1, a[0]);
+        for (unsigned i = 1; i + 1 < n; ++i)
+            r[n + i] = addmul_1(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+        r[2 * n - 1] = 0;
+
+        lshift1(r, 2 * n);
+
+        Limb c = 0;
+        for (unsigned i = 0; i < n; ++i) {
+            const Limb2 s = static_cast<Limb2>(a[i]) * a[i];
+            Limb2 v = static_cast<Limb2>(r[2 * i]) + static_cast<Limb>(s) + c;
+            r[2 * i] = static_cast<Limb>(v);
+            v = static_cast<Limb2>(r[2 * i + 1]) +
+                static_cast<Limb>(s >> LIMB_BITS) +
+                static_cast<Limb>(v >> LIMB_BITS);
+            r[2 * i + 1] = static_cast<Limb>(v);
+            c = static_cast<Limb>(v >> LIMB_BITS);
         }
+    }
 
-        while (carry) {
-            const Limb v = *r + carry;
-            carry = v < *r;
-            *r++ = v;
+    // a much longer than b: the balanced products of b and pieces of a
+    // are accumulated
+    void mul_unbalanced(Limb* r, const Limb* a, unsigned m, const Limb* b, unsigned n, Arena& arena)
+    {
+        Arena::Mark mark(arena);
+
+        mul_mn(r, a, n, b, n, arena);
+
+        Limb* t = arena.alloc<Limb>(2 * n);
+
+        for (unsigned i = n; i < m; i += n) {
+            const unsigned c = std::min(n, m - i);
+
+            if (c == n)
+                mul_mn(t, a + i, n, b, n, arena);
+            else
+                mul_mn(t, b, n, a + i, c, arena);
+
+            // the limbs of r from i + n on are not set yet
+            const Limb carry = add_n(r + i, r + i, t, n);
+            add_1(r + i + n, t + n, c, carry);
         }
     }
 
-    bool ssub(NN& a, const NN& b)
+    // Karatsuba: with a = a0 + a1 X and b = b0 + b1 X, X = B^k,
+    // a b = a0 b0 + (a0 b0 + a1 b1 - (a0 - a1) (b0 - b1)) X + a1 b1 X^2;
+    // needs n > m / 2
+    void mul_toom22(Limb* r, const Limb* a, unsigned m, const Limb* b, unsigned n, Arena& arena)
     {
-        if (a >= b) {
-            a -= b;
-            return true;
+        const unsigned k = m / 2;
+        const unsigned ma = m - k;
+        const unsigned nb = n - k;
+        const unsigned nd = std::max(k, nb);
+
+        assert(k > 0 && nb > 0 && ma >= nd);
+
+        Arena::Mark mark(arena);
+
+        Limb* da = arena.alloc<Limb>(ma);
+        Limb* db = arena.alloc<Limb>(nd);
+        const bool neg = abs_sub(da, a, k, a + k, ma) != abs_sub(db, b, k, b + k, nb);
+
+        Limb* d = arena.alloc<Limb>(ma + nd);
+
+        fork(parallel(n),
+             [&] { mul_mn(d, da, ma, db, nd, Arena::local()); },
+             [&] { mul_mn(r, a, k, b, k, Arena::local()); },
+             [&] { mul_mn(r + 2 * k, a + k, ma, b + k, nb, Arena::local()); });
+
+        const unsigned nt = ma + nd + 1;
+        Limb* t = arena.alloc<Limb>(nt);
+
+        std::copy(r, r + 2 * k, t);
+        std::fill(t + 2 * k, t + nt, 0);
+        add_mn(t, t, nt, r + 2 * k, ma + nb);
+
+        if (neg)
+            add_mn(t, t, nt, d, ma + nd);
+        else
+            sub_mn(t, t, nt, d, ma + nd);
+
+        add_mn(r + k, r + k, m + n - k, t, nt);
+    }
+
+    void sqr_toom22(Limb* r, const Limb* a, unsigned n, Arena& arena)
+    {
+        const unsigned k = n / 2;
+        const unsigned ma = n - k;
+
+        assert(k > 0);
+
+        Arena::Mark mark(arena);
+
+        Limb* da = arena.alloc<Limb>(ma);
+        abs_sub(da, a, k, a + k, ma);
+
+        Limb* d = arena.alloc<Limb>(2 * ma);
+
+        fork(parallel(n),
+             [&] { sqr_n(d, da, ma, Arena::local()); },
+             [&] { sqr_n(r, a, k, Arena::local()); },
+             [&] { sqr_n(r + 2 * k, a + k, ma, Arena::local()); });
+
+        const unsigned nt = 2 * ma + 1;
+        Limb* t = arena.alloc<Limb>(nt);
+
+        std::copy(r, r + 2 * k, t);
+        std::fill(t + 2 * k, t + nt, 0);
+        add_mn(t, t, nt, r + 2 * k, 2 * ma);
+        sub_mn(t, t, nt, d, 2 * ma);
+
+        add_mn(r + k, r + k, 2 * n - k, t, nt);
+    }
+
+    // Toom-3: the operands are split into three pieces of k limbs,
+    // x = x0 + x1 X + x2 X^2 with X = B^k, evaluated at 0, 1, -1, -2 and
+    // infinity, the values are multiplied pointwise and the product is
+    // interpolated from them.
+
+    // the value at 1 into p1, those at -1 and -2 as magnitude and sign,
+    // all k + 1 limbs
+    void toom33_evaluate(const Limb* x, unsigned k,
+                         Limb* p1,
+                         Limb* p_1, bool& p_1n,
+                         Limb* p_2, bool& p_2n)
+    {
+        const Limb* x0 = x;
+        const Limb* x1 = x + k;
+        const Limb* x2 = x + 2 * k;
+
+        // p1 <- x0 + x2, p_1 <- x0 + x2 - x1, p1 <- x0 + x2 + x1
+        p1[k] = add_n(p1, x0, x2, k);
+        p_1n = abs_sub(p_1, p1, k + 1, x1, k);
+        p1[k] += add_n(p1, p1, x1, k);
+
+        // p_2 <- (p_1 + x2) * 2 - x0
+        if (p_1n) {
+            p_2n = abs_sub(p_2, x2, k, p_1, k + 1);
+        } else {
+            p_2[k] = p_1[k] + add_n(p_2, p_1, x2, k);
+            p_2n = false;
         }
 
-        NN t(a);
-        a = b;
-        a -= t;
+        lshift1(p_2, k + 1);
 
-        return false;
+        if (p_2n)
+            add_mn(p_2, p_2, k + 1, x0, k);
+        else
+            p_2n = abs_sub(p_2, p_2, k + 1, x0, k);
     }
 
-    void sadd(NN& a, bool& ap, const NN& b, bool bp)
+    // a <- a + b for signed values of n limbs
+    void signed_add(Limb* a, bool& an, const Limb* b, bool bn, unsigned n)
     {
-        if (ap == bp) {
-            a += b;
-            return;
+        if (an == bn) {
+            add_n(a, a, b, n);
+        } else if (cmp_n(a, b, n) >= 0) {
+            sub_n(a, a, b, n);
+        } else {
+            sub_n(a, b, a, n);
+            an = bn;
         }
+    }
 
-        if (ap && !bp) {
-            ap = ssub(a, b);
+    // r <- r + x X^o modulo B^nr, for x of nx limbs
+    void add_at(Limb* r, unsigned nr, const Limb* x, unsigned nx, unsigned o)
+    {
+        if (o >= nr)
             return;
-        }
 
-        NN t(a);
-        a = b;
-        ap = ssub(a, t);
+        const unsigned l = std::min(nx, nr - o);
+        const Limb c = add_n(r + o, r + o, x, l);
+        add_1(r + o + l, r + o + l, nr - o - l, c);
+    }
+
+    // r <- r - x X^o modulo B^nr, for x of nx limbs
+    void sub_at(Limb* r, unsigned nr, const Limb* x, unsigned nx, unsigned o)
+    {
+        if (o >= nr)
+            return;
+
+        const unsigned l = std::min(nx, nr - o);
+        const Limb c = sub_n(r + o, r + o, x, l);
+        sub_1(r + o + l, r + o + l, nr - o - l, c);
+    }
+
+    // Assembles the product in the nr limbs of r from its values; r holds
+    // the value at 0 in its first 2 k limbs on entry. The values at 1, -1
+    // and -2 are of 2 k + 2 limbs and are overwritten, the one at infinity
+    // is of 2 k limbs. The product is the exact result, so it is computed
+    // modulo B^nr and the intermediate values may wrap around.
+    void toom33_interpolate(Limb* r, unsigned nr, unsigned k,
+                            Limb* r1,
+                            Limb* r_1, bool r_1n,
+                            Limb* r_2, bool r_2n,
+                            const Limb* r4,
+                            Arena& arena)
+    {
+        const unsigned w = 2 * k + 2;
+
+        Arena::Mark mark(arena);
+
+        Limb* r0 = arena.alloc<Limb>(w);
+        std::copy(r, r + 2 * k, r0);
+        r0[2 * k] = r0[2 * k + 1] = 0;
+
+        Limb* t = arena.alloc<Limb>(w);
+        std::copy(r4, r4 + 2 * k, t);
+        t[2 * k] = t[2 * k + 1] = 0;
+
+        // r3 <- (r_2 - r1) / 3
+        Limb* r3 = r_2;
+        bool r3n = r_2n;
+        signed_add(r3, r3n, r1, true, w);
+        divexact_by3(r3, w);
+
+        // r1 <- (r1 - r_1) / 2
+        bool r1n = false;
+        signed_add(r1, r1n, r_1, !r_1n, w);
+        rshift1(r1, w);
+
+        // r2 <- r_1 - r0
+        Limb* r2 = r_1;
+        bool r2n = r_1n;
+        signed_add(r2, r2n, r0, true, w);
+
+        // r3 <- (r2 - r3) / 2 + 2 r4
+        r3n = !r3n;
+        signed_add(r3, r3n, r2, r2n, w);
+        rshift1(r3, w);
+        signed_add(r3, r3n, t, false, w);
+        signed_add(r3, r3n, t, false, w);
+
+        // r2 <- r2 + r1 - r4
+        signed_add(r2, r2n, r1, r1n, w);
+        signed_add(r2, r2n, t, true, w);
+
+        // r1 <- r1 - r3
+        signed_add(r1, r1n, r3, !r3n, w);
+
+        std::fill(r + 2 * k, r + std::min(4 * k, nr), 0);
+        if (nr > 4 * k)
+            std::copy(r4, r4 + std::min(2 * k, nr - 4 * k), r + 4 * k);
+
+        (r1n ? sub_at : add_at)(r, nr, r1, w, k);
+        (r2n ? sub_at : add_at)(r, nr, r2, w, 2 * k);
+        (r3n ? sub_at : add_at)(r, nr, r3, w, 3 * k);
+    }
+
+    // x of n limbs padded with zeros to l limbs
+    const Limb* pad(const Limb* x, unsigned n, unsigned l, Arena& arena)
+    {
+        if (n == l)
+            return x;
+
+        Limb* p = arena.alloc<Limb>(l);
+        std::copy(x, x + n, p);
+        std::fill(p + n, p + l, 0);
+
+        return p;
+    }
+
+    // needs 3 n >= 2 m
+    void mul_toom33(Limb* r, const Limb* a, unsigned m, const Limb* b, unsigned n, Arena& arena)
+    {
+        const unsigned k = (m + 2) / 3;
+
+        Arena::Mark mark(arena);
+
+        const Limb* x = pad(a, m, 3 * k, arena);
+        const Limb* y = pad(b, n, 3 * k, arena);
+
+        Limb* e = arena.alloc<Limb>(6 * (k + 1));
+        bool p_1n, p_2n, q_1n, q_2n;
+        toom33_evaluate(x, k, e, e + k + 1, p_1n, e + 2 * (k + 1), p_2n);
+        toom33_evaluate(y, k, e + 3 * (k + 1), e + 4 * (k + 1), q_1n, e + 5 * (k + 1), q_2n);
+
+        const unsigned w = 2 * k + 2;
+        Limb* v = arena.alloc<Limb>(3 * w + 2 * k);
+
+        auto value = [&](unsigned i) {
+            return [=] {
+                mul_mn(v + i * w, e + i * (k + 1), k + 1, e + (i + 3) * (k + 1), k + 1, Arena::local());
+            };
+        };
+
+        fork(parallel(n),
+             value(0), value(1), value(2),
+             [&] { mul_mn(r, x, k, y, k, Arena::local()); },
+             [&] { mul_mn(v + 3 * w, x + 2 * k, k, y + 2 * k, k, Arena::local()); });
+
+        toom33_interpolate(r, m + n, k,
+                           v, v + w, p_1n != q_1n, v + 2 * w, p_2n != q_2n,
+                           v + 3 * w, arena);
     }
 
-    void ssub(NN& a, bool& ap, const NN& b, bool bp)
+    void sqr_toom33(Limb* r, const Limb* a, unsigned n, Arena& arena)
     {
-        sadd(a, ap, b, !bp);
-        return;
+        const unsigned k = (n + 2) / 3;
+
+        Arena::Mark mark(arena);
+
+        const Limb* x = pad(a, n, 3 * k, arena);
+
+        Limb* e = arena.alloc<Limb>(3 * (k + 1));
+        bool p_1n, p_2n;
+        toom33_evaluate(x, k, e, e + k + 1, p_1n, e + 2 * (k + 1), p_2n);
+
+        const unsigned w = 2 * k + 2;
+        Limb* v = arena.alloc<Limb>(3 * w + 2 * k);
+
+        auto value = [&](unsigned i) {
+            return [=] { sqr_n(v + i * w, e + i * (k + 1), k + 1, Arena::local()); };
+        };
+
+        fork(parallel(n),
+             value(0), value(1), value(2),
+             [&] { sqr_n(r, x, k, Arena::local()); },
+             [&] { sqr_n(v + 3 * w, x + 2 * k, k, Arena::local()); });
+
+        toom33_interpolate(r, 2 * n, k,
+                           v, v + w, false, v + 2 * w, false,
+                           v + 3 * w, arena);
     }
 
+
     const Limb2 log2x2to31[] = {
         2147483648, 1354911328, 1073741824, 924870866, 830760077, 764949109,
         715827882,  677455664,  646456993,  620761987, 599025414, 580332017,
@@ -97,11 +705,292 @@ namespace {
         496880929,  488918136,  481559945,  474732891, 468375400, 462435433,
         456868671,  451637109,  446707947,  442052706, 437646531, 433467612,
         429496729,  425716864,  422112891,  418671311, 415380038};
+
+    // Number-theoretic transform multiplication. The operands are split
+    // into 32-bit words, whatever the limb size, which are convolved modulo
+    // three primes of the form c * 2^k + 1 and recombined with the Chinese
+    // remainder theorem. A convolution coefficient is bounded by
+    // min(m, n) * 2^64, which stays below the product of the primes (about
+    // 2^86) for every transform length the primes support.
+    typedef std::uint32_t Word;
+    typedef std::uint64_t Word2;
+
+    static constexpr int WORD_BITS = sizeof(Word) * CHAR_BIT;
+    static constexpr Word2 WORD_MAX_VALUE = std::numeric_limits<Word>::max();
+    static constexpr unsigned WORDS_PER_LIMB = LIMB_BITS / WORD_BITS;
+
+    constexpr Word NTT_P1 = 469762049; // 7 * 2^26 + 1
+    constexpr Word NTT_P2 = 167772161; // 5 * 2^25 + 1
+    constexpr Word NTT_P3 = 998244353; // 119 * 2^23 + 1
+    constexpr Word NTT_G = 3;
+
+    constexpr unsigned NTT_MAX_LOG_LENGTH = 23;
+
+
+    Word word(const Limb* a, std::size_t i)
+    {
+        return static_cast<Word>(a[i / WORDS_PER_LIMB] >>
+                                 (i % WORDS_PER_LIMB * WORD_BITS));
+    }
+
+
+    template <Word P> Word pow_mod(Word a, Word e)
+    {
+        Word r = 1;
+
+        while (e) {
+            if (e & 1)
+                r = static_cast<Word2>(r) * a % P;
+            a = static_cast<Word2>(a) * a % P;
+            e >>= 1;
+        }
+
+        return r;
+    }
+
+    // u + v w and u - v w for u from p, v from q
+    template <Word P>
+    void ntt_butterflies(Word* __restrict p, Word* __restrict q, const Word* w, unsigned n)
+    {
+        for (unsigned j = 0; j < n; ++j) {
+            const Word u = p[j];
+            const Word v = static_cast<Word2>(q[j]) * w[j] % P;
+            p[j] = u + v < P ? u + v : u + v - P;
+            q[j] = u >= v ? u - v : u + P - v;
+        }
+    }
+
+    // the passes over the data are split among the threads of tp, if any
+    template <Word P>
+    void ntt(Word* a, unsigned n, bool inverse, ThreadPool* tp, Arena& arena)
+    {
+        Arena::Mark mark(arena);
+
+        unsigned log_n = 0;
+        while ((1u << log_n) < n)
+            log_n += 1;
+
+        split(tp, n, [=](std::size_t b, std::size_t e) {
+            unsigned j = 0;
+            for (unsigned k = 0; k < log_n; ++k)
+                if (b & (1u << k))
+                    j |= 1u << (log_n - 1 - k);
+
+            for (std::size_t i = b; i < e; ++i) {
+                if (i < j)
+                    std::swap(a[i], a[j]);
+
+                unsigned bit = n >> 1;
+                for (; j & bit; bit >>= 1)
+                    j ^= bit;
+                j ^= bit;
+            }
+        });
+
+        Word* w = arena.alloc<Word>(n / 2);
+
+        for (unsigned s = 1; s <= log_n; ++s) {
+            const unsigned len = 1u << s;
+            const unsigned h = len / 2;
+
+            Word wl = pow_mod<P>(NTT_G, (P - 1) / len);
+            if (inverse)
+                wl = pow_mod<P>(wl, P - 2);
+
+            split(tp, h, [=](std::size_t b, std::size_t e) {
+                w[b] = pow_mod<P>(wl, b);
+                for (std::size_t j = b + 1; j < e; ++j)
+                    w[j] = static_cast<Word2>(w[j - 1]) * wl % P;
+            });
+
+            // whole blocks of len words, or pieces of them while there
+            // are too few to go round
+            if (!tp || n / len >= 16 * tp->size())
+                split(tp, n / len, [=](std::size_t b, std::size_t e) {
+                    for (std::size_t i = b * len; i < e * len; i += len)
+                        ntt_butterflies<P>(a + i, a + i + h, w, h);
+                }, h);
+            else
+                split(tp, n / 2, [=](std::size_t b, std::size_t e) {
+                    // butterfly t works on block t / h at offset t % h
+                    for (std::size_t t = b; t < e;) {
+                        const std::size_t i = t / h * len;
+                        const std::size_t j = t % h;
+                        const std::size_t l = std::min(h - j, e - t);
+
+                        ntt_butterflies<P>(a + i + j, a + i + h + j, w + j, l);
+
+                        t += l;
+                    }
+                });
+        }
+
+        if (inverse) {
+            const Word n_inv = pow_mod<P>(n, P - 2);
+            split(tp, n, [=](std::size_t b, std::size_t e) {
+                for (std::size_t i = b; i < e; ++i)
+                    a[i] = static_cast<Word2>(a[i]) * n_inv % P;
+            });
+        }
+    }
+
+    // f <- the words of a of m limbs modulo P, padded with zeros to l
+    template <Word P>
+    void ntt_load(Word* f, const Limb* a, unsigned m, unsigned l, ThreadPool* tp)
+    {
+        split(tp, l, [=](std::size_t b, std::size_t e) {
+            for (std::size_t i = b; i < e; ++i)
+                f[i] = i < m * WORDS_PER_LIMB ? word(a, i) % P : 0;
+        });
+    }
+
+    // fa <- a * b modulo P, or a^2 if b is null, by transforms of length n
+    template <Word P>
+    void ntt_convolve(Word* fa,
+                      const Limb* a,
+                      unsigned m,
+                      const Limb* b,
+                      unsigned n,
+                      unsigned l,
+                      ThreadPool* tp,
+                      Arena& arena)
+    {
+        Arena::Mark mark(arena);
+
+        Word* fb = b ? arena.alloc<Word>(l) : fa;
+
+        fork(b ? tp : nullptr,
+             [&] {
+                 ntt_load<P>(fa, a, m, l, tp);
+                 ntt<P>(fa, l, false, tp, Arena::local());
+             },
+             [&] {
+                 if (b) {
+                     ntt_load<P>(fb, b, n, l, tp);
+                     ntt<P>(fb, l, false, tp, Arena::local());
+                 }
+             });
+
+        split(tp, l, [=](std::size_t b, std::size_t e) {
+            for (std::size_t i = b; i < e; ++i)
+                fa[i] = static_cast<Word2>(fa[i]) * fb[i] % P;
+        });
+
+        ntt<P>(fa, l, true, tp, arena);
+    }
+
+    // the transform length is limited by the 2-adic order of the primes
+    static constexpr unsigned MUL_FFT_MAX_LIMBS =
+        (1u << NTT_MAX_LOG_LENGTH) / WORDS_PER_LIMB;
+
+    // r <- a * b, or a^2 if b is null, for a of m limbs and b of n limbs
+    void mul_fft(Limb* r, const Limb* a, unsigned m, const Limb* b, unsigned n, Arena& arena)
+    {
+        const unsigned nl = m + n;
+        const unsigned nr = nl * WORDS_PER_LIMB;
+
+        unsigned l = 1;
+        while (l < nr)
+            l <<= 1;
+
+        Arena::Mark mark(arena);
+
+        Word* r1 = arena.alloc<Word>(l);
+        Word* r2 = arena.alloc<Word>(l);
+        Word* r3 = arena.alloc<Word>(l);
+
+        ThreadPool* tp = parallel(std::min(m, n));
+
+        fork(tp,
+             [&] { ntt_convolve<NTT_P1>(r1, a, m, b, n, l, tp, Arena::local()); },
+             [&] { ntt_convolve<NTT_P2>(r2, a, m, b, n, l, tp, Arena::local()); },
+             [&] { ntt_convolve<NTT_P3>(r3, a, m, b, n, l, tp, Arena::local()); });
+
+        const Word2 p1_inv_p2 = pow_mod<NTT_P2>(NTT_P1 % NTT_P2, NTT_P2 - 2);
+        const Word2 p1_inv_p3 = pow_mod<NTT_P3>(NTT_P1, NTT_P3 - 2);
+        const Word2 p2_inv_p3 = pow_mod<NTT_P3>(NTT_P2, NTT_P3 - 2);
+
+        // Garner's algorithm: x = v1 + p1 * (v2 + p2 * v3), the mixed
+        // radix digits v2 and v3 replacing the residues
+        split(tp, nr, [=](std::size_t b, std::size_t e) {
+            for (std::size_t i = b; i < e; ++i) {
+                const Word2 v1 = r1[i];
+                const Word2 v2 =
+                    (r2[i] + NTT_P2 - v1 % NTT_P2) % NTT_P2 * p1_inv_p2 % NTT_P2;
+                const Word2 v3 =
+                    ((r3[i] + NTT_P3 - v1 % NTT_P3) % NTT_P3 * p1_inv_p3 % NTT_P3 +
+                     NTT_P3 - v2 % NTT_P3) %
+                    NTT_P3 * p2_inv_p3 % NTT_P3;
+
+                r2[i] = static_cast<Word>(v2);
+                r3[i] = static_cast<Word>(v3);
+            }
+        });
+
+        std::fill(r, r + nl, 0);
+
+        // 128-bit carry kept as two 64-bit halves
+        Word2 c0 = 0;
+        Word2 c1 = 0;
+
+        for (unsigned i = 0; i < nr; ++i) {
+            const Word2 v1 = r1[i];
+            const Word2 y = r2[i] + static_cast<Word2>(NTT_P2) * r3[i];
+
+            const Word2 lo = (y & WORD_MAX_VALUE) * NTT_P1 + v1;
+            const Word2 hi = (y >> WORD_BITS) * NTT_P1;
+
+            c0 += lo;
+            c1 += c0 < lo;
+
+            const Word2 t = hi << WORD_BITS;
+            c0 += t;
+            c1 += (c0 < t) + (hi >> WORD_BITS);
+
+            r[i / WORDS_PER_LIMB] |=
+                static_cast<Limb>(static_cast<Word>(c0))
+                << (i % WORDS_PER_LIMB * WORD_BITS);
+
+            c0 = (c0 >> WORD_BITS) | (c1 << WORD_BITS);
+            c1 >>= WORD_BITS;
+        }
+
+        assert(c0 == 0 && c1 == 0);
+    }
+
+    void mul_mn(Limb* r, const Limb* a, unsigned m, const Limb* b, unsigned n, Arena& arena)
+    {
+        assert(m >= n && n > 0);
+
+        if (n < NN::MUL_TOOM22_THRESHOLD)
+            mul_basecase(r, a, m, b, n);
+        else if (n >= NN::MUL_FFT_THRESHOLD && m + n <= MUL_FFT_MAX_LIMBS)
+            mul_fft(r, a, m, b, n, arena);
+        else if (2 * n <= m)
+            mul_unbalanced(r, a, m, b, n, arena);
+        else if (n < NN::MUL_TOOM33_THRESHOLD || 3 * n < 2 * m)
+            mul_toom22(r, a, m, b, n, arena);
+        else
+            mul_toom33(r, a, m, b, n, arena);
+    }
+
+    void sqr_n(Limb* r, const Limb* a, unsigned n, Arena& arena)
+    {
+        assert(n > 0);
+
+        if (n < NN::MUL_TOOM22_THRESHOLD)
+            sqr_basecase(r, a, n);
+        else if (n < NN::MUL_TOOM33_THRESHOLD)
+            sqr_toom22(r, a, n, arena);
+        else if (n < NN::MUL_FFT_THRESHOLD || 2 * n > MUL_FFT_MAX_LIMBS)
+            sqr_toom33(r, a, n, arena);
+        else
+            mul_fft(r, a, n, nullptr, n, arena);
+    }
 }
 
 namespace yacas {
     namespace mp {
-
         const NN NN::ZERO = NN(0u);
         const NN NN::ONE = NN(1u);
         const NN NN::TWO = NN(2u);
@@ -109,10 +998,185 @@ namespace yacas {
 
         unsigned NN::MUL_TOOM22_THRESHOLD = 32;
         unsigned NN::MUL_TOOM33_THRESHOLD = 48;
+        unsigned NN::MUL_FFT_THRESHOLD = 1536;
+        unsigned NN::MUL_THREADS_THRESHOLD = 4096;
 
-        unsigned NN::PARSE_DC_THRESHOLD = 512;
+        unsigned NN::PARSE_DC_THRESHOLD = 64;
         unsigned NN::TO_STRING_DC_THRESHOLD = 24;
-        unsigned NN::DIV_REM_DC_THRESHOLD = 4;
+        unsigned NN::DIV_REM_DC_THRESHOLD = 128;
+        unsigned NN::GCD_DC_THRESHOLD = 1600;
+        unsigned NN::HGCD_THRESHOLD = 240;
+        unsigned NN::POWMOD_REDC_THRESHOLD = 512;
+        unsigned NN::FACTORIAL_SWING_THRESHOLD = 2048;
+
+        namespace {
+            // the smallest values the algorithms cope with
+            const struct {
+                const char* name;
+                unsigned* value;
+                unsigned min;
+            } thresholds[] = {
+                {"MUL_TOOM22_THRESHOLD", &NN::MUL_TOOM22_THRESHOLD, 2},
+                {"MUL_TOOM33_THRESHOLD", &NN::MUL_TOOM33_THRESHOLD, 3},
+                {"MUL_FFT_THRESHOLD", &NN::MUL_FFT_THRESHOLD, 2},
+                {"MUL_THREADS_THRESHOLD", &NN::MUL_THREADS_THRESHOLD, 1},
+                {"PARSE_DC_THRESHOLD", &NN::PARSE_DC_THRESHOLD, 1},
+                {"TO_STRING_DC_THRESHOLD", &NN::TO_STRING_DC_THRESHOLD, 3},
+                {"DIV_REM_DC_THRESHOLD", &NN::DIV_REM_DC_THRESHOLD, 2},
+                {"GCD_DC_THRESHOLD", &NN::GCD_DC_THRESHOLD, 4},
+                {"HGCD_THRESHOLD", &NN::HGCD_THRESHOLD, 2},
+                {"POWMOD_REDC_THRESHOLD", &NN::POWMOD_REDC_THRESHOLD, 1},
+                {"FACTORIAL_SWING_THRESHOLD", &NN::FACTORIAL_SWING_THRESHOLD, 1}};
+
+            struct ThresholdsLoader {
+                ThresholdsLoader()
+                {
+                    const char* path = std::getenv("YACAS_MP_THRESHOLDS");
+
+                    if (!path)
+                        return;
+
+                    std::ifstream f(path);
+
+                    try {
+                        if (!f)
+                            throw std::invalid_argument("cannot be opened");
+
+                        NN::load_thresholds(f);
+                    } catch (const std::invalid_argument& e) {
+                        std::cerr << "yacas_mp: ignoring " << path << ": "
+                                  << e.what() << std::endl;
+                    }
+                }
+            } thresholds_loader;
+
+            struct ThreadsLoader {
+                ThreadsLoader()
+                {
+                    const char* value = std::getenv("YACAS_MP_THREADS");
+
+                    if (!value)
+                        return;
+
+                    char* end;
+                    const unsigned long n = std::strtoul(value, &end, 10);
+
+                    if (*value && !*end && n > 0 && n <= 1024)
+                        NN::set_threads(n);
+                    else
+                        std::cerr << "yacas_mp: ignoring YACAS_MP_THREADS="
+                                  << value << std::endl;
+                }
+            } threads_loader;
+        }
+
+        void NN::set_threads(unsigned n)
+        {
+            std::unique_lock<std::shared_mutex> lock(pool_mutex);
+            pool.reset(n > 1 ? new ThreadPool(n) : nullptr);
+        }
+
+        unsigned NN::threads()
+        {
+            std::shared_lock<std::shared_mutex> lock(pool_mutex);
+            return pool ? pool->size() : 1;
+        }
+
+        void NN::load_thresholds(std::istream& is)
+        {
+            // parse everything before touching any threshold
+            std::vector<std::pair<unsigned*, unsigned>> values;
+
+            std::string line;
+            for (unsigned no = 1; std::getline(is, line); ++no) {
+                line = line.substr(0, line.find('#'));
+
+                std::istringstream ls(line);
+
+                std::string name, eq;
+                unsigned long value;
+
+                if (!(ls >> name))
+                    continue;
+
+                if (!(ls >> eq >> value) || eq != "=" || (ls >> eq))
+                    throw std::invalid_argument("malformed line " +
+                                                std::to_string(no));
+
+                if (name == "LIMB_BITS") {
+                    if (value != LIMB_BITS)
+                        throw std::invalid_argument(
+                            "thresholds for " + std::to_string(value) +
+                            "-bit limbs");
+                    continue;
+                }
+
+                auto t = std::find_if(
+                    std::begin(thresholds),
+                    std::end(thresholds),
+                    [&name](const auto& t) { return name == t.name; });
+
+                if (t == std::end(thresholds) || value < t->min ||
+                    value > std::numeric_limits<unsigned>::max())
+                    throw std::invalid_argument("bad threshold on line " +
+                                                std::to_string(no));
+
+                values.emplace_back(t->value, value);
+            }
+
+            for (const auto& v : values)
+                *v.first = v.second;
+        }
+
+        void NN::save_thresholds(std::ostream& os)
+        {
+            os << "LIMB_BITS = " << LIMB_BITS << '\n';
+
+            for (const auto& t : thresholds)
+                os << t.name << " = " << *t.value << '\n';
+        }
+
+        namespace {
+            Limb digit_value(char c)
+            {
+                return std::isdigit(c) ? Limb(c - '0') : Limb((c | 0x20) - 'a' + 10);
+            }
+
+            char digit_char(Limb d)
+            {
+                return d <= 9 ? '0' + d : 'a' + d - 10;
+            }
+
+            // k for b = 2^k, 0 if b is not a power of two
+            unsigned radix_bits(unsigned b)
+            {
+                if (b & (b - 1))
+                    return 0;
+
+                unsigned k = 0;
+                while (b >>= 1)
+                    k += 1;
+                return k;
+            }
+
+            // the largest number of base b digits bd = b^d that fit in a limb
+            unsigned limb_digits(unsigned b, Limb& bd)
+            {
+                unsigned d = 1;
+                bd = b;
+                while (bd <= std::numeric_limits<Limb>::max() / b) {
+                    bd *= b;
+                    d += 1;
+                }
+                return d;
+            }
+
+            // the number of base b digits in n limbs
+            double limbs_to_digits(double n, unsigned b)
+            {
+                return n * LIMB_BITS * log2x2to31[b - 2] / 2147483648.0;
+            }
+        }
 
         NN::NN(std::string_view s, unsigned b)
         {
@@ -125,18 +1189,115 @@ namespace yacas {
             if (p == q)
                 throw ParseError(s, s.length());
 
-            while (p != q && std::isalnum(*p)) {
-                const char c = *p++;
-                const Limb d = std::isdigit(c) ? Limb(c - '0') : Limb((c | 0x20) - 'a' + 10);
-
-                if (d >= b)
+            auto e = p;
+            while (e != q && std::isalnum(*e)) {
+                if (digit_value(*e) >= b)
                     throw ParseError(s, std::distance(s.cbegin(), q));
+                e += 1;
+            }
+
+            if (const unsigned k = radix_bits(b))
+                parse_pow2(&*p, std::distance(p, e), k);
+            else
+                parse_dc(&*p, std::distance(p, e), b);
+
+            drop_zeros();
+        }
+
+        const NN& NN::radix_power(unsigned b, unsigned i)
+        {
+            assert(b > 1);
+            assert(b <= 36);
+
+            // a deque, so that references handed out stay valid as it grows
+            static thread_local std::deque<NN> powers[37];
 
-                mul(b);
-                add(d);
+            std::deque<NN>& p = powers[b];
+
+            if (p.empty())
+                p.emplace_back(b);
+
+            while (p.size() <= i) {
+                NN t(p.back());
+                t.sqr();
+                p.push_back(std::move(t));
+            }
+
+            return p[i];
+        }
+
+        // Digits are gathered into limbs as long as the base power fits, so
+        // that there is only one multiplication by a limb per chunk.
+        void NN::parse_bc(const char* s, std::size_t n, unsigned b)
+        {
+            Limb bd;
+            const unsigned d = limb_digits(b, bd);
+
+            _limbs.clear();
+            _limbs.reserve(n / d + 1);
+
+            for (std::size_t i = 0; i < n;) {
+                const unsigned l = i == 0 && n % d ? n % d : d;
+
+                Limb m = 1;
+                Limb v = 0;
+                for (unsigned j = 0; j < l; ++j) {
+                    m *= b;
+                    v = v * b + digit_value(s[i + j]);
+                }
+                i += l;
+
+                Limb* p = _limbs.data();
+                const unsigned k = _limbs.size();
+                const Limb c = mul_1(p, p, k, m) + add_1(p, p, k, v);
+                if (c)
+                    _limbs.push_back(c);
             }
+        }
 
+        // Every digit of a base 2^k number is a k bit field, which is put
+        // in place directly.
+        void NN::parse_pow2(const char* s, std::size_t n, unsigned k)
+        {
+            _limbs.clear();
+            _limbs.resize((n * k + LIMB_BITS - 1) / LIMB_BITS, 0);
+
+            for (std::size_t i = 0; i < n; ++i) {
+                const Limb v = digit_value(s[n - 1 - i]);
+                const std::size_t j = i * k / LIMB_BITS;
+                const unsigned o = i * k % LIMB_BITS;
+
+                _limbs[j] |= v << o;
+                if (o + k > LIMB_BITS)
+                    _limbs[j + 1] |= v >> (LIMB_BITS - o);
+            }
+        }
+
+        // The digits are split so that the lower part has a power of two
+        // length 2^i, which is then put in place by a multiplication by
+        // the cached power b^(2^i).
+        void NN::parse_dc(const char* s, std::size_t n, unsigned b)
+        {
+            if (n < limbs_to_digits(PARSE_DC_THRESHOLD, b)) {
+                parse_bc(s, n, b);
+                return;
+            }
+
+            unsigned i = 0;
+            while ((std::size_t(2) << i) < n)
+                i += 1;
+
+            const std::size_t k = std::size_t(1) << i;
+
+            NN low;
+            low.parse_dc(s + n - k, k, b);
+            low.drop_zeros();
+
+            parse_dc(s, n - k, b);
             drop_zeros();
+
+            mul(radix_power(b, i));
+            add(low);
         }
 
         std::string NN::to_string(unsigned base) const
@@ -144,8 +1305,17 @@ namespace yacas {
             assert(base > 1);
             assert(base <= 36);
 
-            return _limbs.size() < TO_STRING_DC_THRESHOLD ? to_string_bc(base)
-                                                          : to_string_dc(base);
+            if (const unsigned k = radix_bits(base))
+                return to_string_pow2(k);
+
+            if (_limbs.size() < TO_STRING_DC_THRESHOLD)
+                return to_string_bc(base);
+
+            std::string s;
+            s.reserve(limbs_to_digits(_limbs.size(), base) + 1);
+            to_string_dc(base, s, 0);
+
+            return s;
         }
 
         std::string NN::to_string_bc(unsigned base) const
@@ -159,17 +1329,28 @@ namespace yacas {
             if (base == 10 && _limbs.size() == 1)
                 return std::to_string(_limbs.back());
 
+#ifndef YACAS_MP_LIMB64
             if (base == 10 && _limbs.size() == 2)
                 return std::to_string(
                     (static_cast<Limb2>(_limbs.back()) << LIMB_BITS) +
                     _limbs.front());
+#endif
+
+            // d digits per division by bd = base^d, the last chunk unpadded
+            Limb bd;
+            const unsigned d = limb_digits(base, bd);
 
             NN t(*this);
             std::string s;
+            s.reserve(limbs_to_digits(_limbs.size(), base) + 1);
 
             while (!t._limbs.empty()) {
-                const Limb r = t.div_rem(base);
-                s += r <= 9 ? r + '0' : r - 10 + 'a';
+                Limb r = t.div_rem(bd);
+
+                for (unsigned i = 0; i < d && (r || !t._limbs.empty()); ++i) {
+                    s += digit_char(r % base);
+                    r /= base;
+                }
             }
 
             std::reverse(s.begin(), s.end());
@@ -177,24 +1358,56 @@ namespace yacas {
             return s;
         }
 
-        std::string NN::to_string_dc(unsigned base) const
+        std::string NN::to_string_pow2(unsigned k) const
         {
-            assert(base > 1);
-            assert(base <= 36);
+            if (_limbs.empty())
+                return "0";
+
+            const unsigned long n = (no_bits() + k - 1) / k;
+            const Limb mask = (Limb(1) << k) - 1;
+
+            std::string s(n, '0');
+
+            for (unsigned long i = 0; i < n; ++i) {
+                const std::size_t j = i * k / LIMB_BITS;
+                const unsigned o = i * k % LIMB_BITS;
+
+                Limb v = _limbs[j] >> o;
+                if (o + k > LIMB_BITS && j + 1 < _limbs.size())
+                    v |= _limbs[j + 1] << (LIMB_BITS - o);
 
-            if (_limbs.size() < 3)
-                return to_string(base);
+                s[n - 1 - i] = digit_char(v & mask);
+            }
+
+            return s;
+        }
+
+        // Appends the digits to s, padded with zeros to width. The number
+        // is split by the largest cached power b^(2^i) with at most half
+        // as many digits.
+        void NN::to_string_dc(unsigned base, std::string& s, std::size_t width) const
+        {
+            if (_limbs.size() < std::max(TO_STRING_DC_THRESHOLD, 3u)) {
+                const std::string r = to_string_bc(base);
+                if (width > r.length())
+                    s.append(width - r.length(), '0');
+                s += r;
+                return;
+            }
 
-            const unsigned k = (no_bits() * log2x2to31[base - 2]) >> 32;
+            const unsigned long h = (no_bits() * log2x2to31[base - 2]) >> 32;
 
-            NN Bk(base);
-            Bk.pow(k);
+            unsigned i = 0;
+            while ((2ul << i) <= h)
+                i += 1;
 
-            NN Q(*this);
-            const NN R = Q.div_rem(Bk);
+            const std::size_t k = std::size_t(1) << i;
 
-            const std::string r = R.to_string(base);
-            return Q.to_string(base) + std::string(k - r.length(), '0') + r;
+            NN q(*this);
+            const NN r = q.div_rem(radix_power(base, i));
+
+            q.to_string_dc(base, s, width > k ? width - k : 0);
+            r.to_string_dc(base, s, k);
         }
 
         void NN::shift_left(unsigned n)
@@ -220,6 +1433,11 @@ namespace yacas {
 
         void NN::shift_right(unsigned n)
         {
+            if (n / LIMB_BITS >= _limbs.size()) {
+                _limbs.clear();
+                return;
+            }
+
             if (n >= LIMB_BITS) {
                 _limbs.erase(_limbs.begin(), _limbs.begin() + n / LIMB_BITS);
                 n %= LIMB_BITS;
@@ -372,7 +1590,7 @@ namespace yacas {
 
             if (is_zero()) {
                 _limbs = a._limbs;
-                shift_left(shift);
+                shift_left(shift * LIMB_BITS);
                 return;
             }
 
@@ -389,9 +1607,9 @@ namespace yacas {
             Limb carry = 0;
 
             for (unsigned i = 0; i < na; ++i) {
-                const Limb v = *p + *q++ + carry;
-                carry = v < *p;
-                *p++ = v;
+                const Limb2 v = static_cast<Limb2>(*p) + *q++ + carry;
+                carry = static_cast<Limb>(v >> LIMB_BITS);
+                *p++ = static_cast<Limb>(v);
                 assert(p <= _limbs.data() + _limbs.size());
             }
 
@@ -434,9 +1652,9 @@ namespace yacas {
             Limb borrow = 0;
 
             for (unsigned i = 0; i < na; ++i) {
-                const Limb v = *p - *q++ - borrow;
-                borrow = v > *p;
-                *p++ = v;
+                const Limb2 v = static_cast<Limb2>(*p) - *q++ - borrow;
+                borrow = (v >> LIMB_BITS) != 0;
+                *p++ = static_cast<Limb>(v);
                 assert(p <= _limbs.data() + _limbs.size());
             }
 
@@ -450,197 +1668,181 @@ namespace yacas {
             drop_zeros();
         }
 
-        void NN::mul(const NN& a) { mul_bc(a); }
-
-        void NN::mul_bc(const NN& a)
+        void NN::mul(const NN& a)
         {
-            const unsigned m = _limbs.size();
-            const unsigned n = a._limbs.size();
+            if (this == &a) {
+                sqr();
+                return;
+            }
 
-            Limbs result(m + n, 0);
+            if (_limbs.empty() || a._limbs.empty()) {
+                _limbs.clear();
+                return;
+            }
 
-            Limb* __restrict r = result.data();
+            const Limbs& u = _limbs.size() >= a._limbs.size() ? _limbs : a._limbs;
+            const Limbs& v = _limbs.size() >= a._limbs.size() ? a._limbs : _limbs;
 
-            if (m >= n) {
-                const Limb* __restrict p = _limbs.data();
-                for (unsigned i = 0; i < n; ++i)
-                    if (const Limb u = a._limbs[i])
-                        _mul(p, m, u, r + i);
-            } else {
-                const Limb* __restrict q = a._limbs.data();
-                for (unsigned i = 0; i < m; ++i)
-                    if (const Limb u = _limbs[i])
-                        _mul(q, n, u, r + i);
-            }
+            Limbs r(u.size() + v.size());
 
-            _limbs = std::move(result);
+            PoolLock lock(u.size());
+            Arena& arena = Arena::local();
+            Arena::Mark mark(arena);
+            mul_mn(r.data(), u.data(), u.size(), v.data(), v.size(), arena);
 
+            _limbs = std::move(r);
             drop_zeros();
         }
 
         void NN::sqr()
-        {
-            const unsigned n = _limbs.size();
-
-            if (n < MUL_TOOM22_THRESHOLD)
-                sqr_bc();
-            else if (n < MUL_TOOM33_THRESHOLD)
-                sqr_toom22();
-            else
-                sqr_toom33();
-        }
-
-        void NN::sqr_bc()
         {
             if (_limbs.empty())
                 return;
 
-            const unsigned n = _limbs.size();
-
-            Limbs c(2 * n, 0);
-
-            const Limb* __restrict p = _limbs.data();
-            Limb* __restrict r = c.data();
-
-            for (unsigned i = 0; i < n; ++i)
-                if (const Limb u = p[i])
-                    _mul(p, n, u, r + i);
+            Limbs r(2 * _limbs.size());
 
-            _limbs = std::move(c);
+            PoolLock lock(_limbs.size());
+            Arena& arena = Arena::local();
+            Arena::Mark mark(arena);
+            sqr_n(r.data(), _limbs.data(), _limbs.size(), arena);
 
+            _limbs = std::move(r);
             drop_zeros();
         }
 
-        void NN::sqr_toom22()
+        void NN::addmul(const NN& a, const NN& b)
         {
-            const unsigned n = _limbs.size();
+            if (a._limbs.empty() || b._limbs.empty())
+                return;
 
-            assert(n >= 2);
+            const NN& u = a._limbs.size() >= b._limbs.size() ? a : b;
+            const NN& v = a._limbs.size() >= b._limbs.size() ? b : a;
 
-            const unsigned k = n / 2;
+            const unsigned m = u._limbs.size();
+            const unsigned n = v._limbs.size();
 
-            NN x0, x1;
+            if (n == 1 && &u != this) {
+                // the common case of a small factor needs no temporary
+                const Limb l = v._limbs.front();
 
-            x1._limbs.assign(_limbs.begin(), _limbs.begin() + k);
-            x1.drop_zeros();
-            x0._limbs.assign(_limbs.begin() + k, _limbs.end());
-            x0.drop_zeros();
+                if (_limbs.size() < m)
+                    _limbs.resize(m, 0);
+                _limbs.push_back(0);
 
-            NN d;
-            if (x0 < x1) {
-                d = x1;
-                d.sub(x0);
-            } else {
-                d = x0;
-                d.sub(x1);
+                Limb* p = _limbs.data();
+                const Limb c = addmul_1(p, u._limbs.data(), m, l);
+                add_1(p + m, p + m, _limbs.size() - m, c);
+
+                drop_zeros();
+                return;
             }
 
-            d.sqr();
-            x0.sqr();
-            x1.sqr();
+            PoolLock lock(m);
+            Arena& arena = Arena::local();
+            Arena::Mark mark(arena);
 
-            _limbs = x1._limbs;
-            x1.add(x0);
-            add(x1, k);
-            add(x0, 2 * k);
-            sub(d, k);
+            Limb* t = arena.alloc<Limb>(m + n);
+            mul_mn(t, u._limbs.data(), m, v._limbs.data(), n, arena);
+
+            const unsigned tn = t[m + n - 1] ? m + n : m + n - 1;
+
+            if (_limbs.size() < tn)
+                _limbs.resize(tn, 0);
+            _limbs.push_back(0);
+
+            add_mn(_limbs.data(), _limbs.data(), _limbs.size(), t, tn);
+
+            drop_zeros();
         }
 
-        void NN::sqr_toom33()
+        bool NN::submul(const NN& a, const NN& b)
         {
-            const unsigned n = _limbs.size();
+            if (a._limbs.empty() || b._limbs.empty())
+                return false;
 
-            assert(n >= 3);
+            const NN& u = a._limbs.size() >= b._limbs.size() ? a : b;
+            const NN& v = a._limbs.size() >= b._limbs.size() ? b : a;
 
-            const unsigned k = (n + 1) / 3;
+            const unsigned m = u._limbs.size();
+            const unsigned n = v._limbs.size();
 
-            NN x0, x1, x2;
+            Limb borrow = 0;
 
-            x0._limbs.assign(_limbs.begin(), _limbs.begin() + k);
-            x0.drop_zeros();
-            x1._limbs.assign(_limbs.begin() + k, _limbs.begin() + 2 * k);
-            x1.drop_zeros();
-            x2._limbs.assign(_limbs.begin() + 2 * k, _limbs.end());
-            x2.drop_zeros();
+            if (n == 1 && &u != this) {
+                const Limb l = v._limbs.front();
 
-            // p0 <- x0
-            NN p0(x0);
+                if (_limbs.size() < m + 1)
+                    _limbs.resize(m + 1, 0);
 
-            // t <- x0 + x2
-            NN t(x0);
-            t += x2;
+                Limb* p = _limbs.data();
+                const Limb c = submul_1(p, u._limbs.data(), m, l);
+                borrow = sub_1(p + m, p + m, _limbs.size() - m, c);
+            } else {
+                PoolLock lock(m);
+                Arena& arena = Arena::local();
+                Arena::Mark mark(arena);
 
-            // p1 <- t + x1
-            NN p1(t);
-            p1 += x1;
+                Limb* t = arena.alloc<Limb>(m + n);
+                mul_mn(t, u._limbs.data(), m, v._limbs.data(), n, arena);
 
-            // p_1 <- t - x1
-            NN p_1(t);
-            bool p_1p = ssub(p_1, x1);
+                if (_limbs.size() < m + n)
+                    _limbs.resize(m + n, 0);
 
-            // p_2 <- (p_1 + x2) * 2 − x0
-            NN p_2(p_1);
-            bool p_2p = p_1p;
-            sadd(p_2, p_2p, x2, true);
-            p_2.shift_left(1);
-            ssub(p_2, p_2p, x0, true);
+                borrow = sub_mn(_limbs.data(), _limbs.data(), _limbs.size(), t, m + n);
+            }
 
-            NN pi(x2);
+            // the difference went negative and is in two's complement
+            if (borrow)
+                neg_n(_limbs.data(), _limbs.size());
 
-            pi.sqr();
-            p_2.sqr();
-            p1.sqr();
-            p_1.sqr();
-            p0.sqr();
+            drop_zeros();
 
-            NN r0(p0);
-            NN r4(pi);
+            return borrow != 0;
+        }
+
+        void NN::divexact(const NN& d)
+        {
+            if (d.is_zero())
+                throw DivisionByZeroError(to_string());
 
-            // r3 <- (p_2 - p1) / 3
-            NN r3(p_2);
-            bool r3p = ssub(r3, p1);
-            r3.div(3);
+            if (is_zero())
+                return;
 
-            // r1 <- (p1 - p_1) / 2
-            NN r1(p1);
-            bool r1p = ssub(r1, p_1);
-            r1.shift_right(1);
+            if (d._limbs.size() >= DIV_REM_DC_THRESHOLD &&
+                _limbs.size() - d._limbs.size() >= DIV_REM_DC_THRESHOLD) {
+                div(d);
+                return;
+            }
 
-            // r2 <- p_1 - r0
-            NN r2(p_1);
-            bool r2p = ssub(r2, r0);
+            // make the divisor odd; the factors of two it has, the
+            // dividend has too
+            unsigned z = 0;
+            while (d._limbs[z] == 0)
+                ++z;
+            const unsigned k = ctz(d._limbs[z]);
 
-            // r3 <- (r2 − r3)/2 + 2 * pi
-            r3p = !r3p;
-            sadd(r3, r3p, r2, r2p);
-            r3.shift_right(1);
-            pi.shift_left(1);
-            sadd(r3, r3p, pi, true);
+            const unsigned n = d._limbs.size() - z;
+            const unsigned qn = _limbs.size() - d._limbs.size() + 1;
 
-            // r2 <- r2 + r1 - r4
-            sadd(r2, r2p, r1, r1p);
-            ssub(r2, r2p, r4, true);
+            Arena& arena = Arena::local();
+            Arena::Mark mark(arena);
 
-            // r1 <- r1 - r3
-            ssub(r1, r1p, r3, r3p);
+            Limb* b = arena.alloc<Limb>(n);
+            rshift(b, d._limbs.data() + z, n, k);
 
-            _limbs = r0._limbs;
+            // the quotient is determined by the low qn limbs of the
+            // dividend shifted right, which needs one limb more
+            const unsigned an = std::min<unsigned>(qn + 1, _limbs.size() - z);
+            Limb* a = arena.alloc<Limb>(an);
+            rshift(a, _limbs.data() + z, an, k);
 
-            if (r1p)
-                add(r1, k);
-            if (r2p)
-                add(r2, 2 * k);
-            if (r3p)
-                add(r3, 3 * k);
+            const unsigned bn = b[n - 1] ? n : n - 1;
 
-            add(r4, 4 * k);
+            Limbs q(qn);
+            divexact_bc(q.data(), a, qn, b, bn);
 
-            if (!r1p)
-                sub(r1, k);
-            if (!r2p)
-                sub(r2, 2 * k);
-            if (!r3p)
-                sub(r3, 3 * k);
+            _limbs = std::move(q);
+            drop_zeros();
         }
 
         void NN::pow(unsigned n)
@@ -678,98 +1880,266 @@ namespace yacas {
                 return ZERO;
             }
 
-            return div_rem_bc(d);
+            if (d._limbs.size() == 1) {
+                const NN r(div_rem(d._limbs.front()));
+                return r;
+            }
+
+            if (d._limbs.size() < DIV_REM_DC_THRESHOLD ||
+                _limbs.size() - d._limbs.size() < DIV_REM_DC_THRESHOLD)
+                return div_rem_bc(d);
+
+            return div_rem_dc(d);
         }
 
         NN NN::div_rem_bc(const NN& d)
         {
-            assert(!d.is_zero());
+            assert(d._limbs.size() >= 2);
 
-            NN A(*this);
-            NN B(d);
+            if (*this < d) {
+                NN r;
+                r._limbs.swap(_limbs);
+                return r;
+            }
 
-#ifdef _MSC_VER
-            unsigned long index = 0;
-            _BitScanReverse(&index, B._limbs.back());
-            const unsigned k = 31 - index;
-#else
-            const unsigned k = __builtin_clz(B._limbs.back());
-#endif
+            const unsigned k = clz(d._limbs.back());
 
-            B <<= k;
-            A <<= k;
+            const unsigned n = d._limbs.size();
+            const unsigned m = _limbs.size() - n;
 
-            const unsigned n = B._limbs.size();
-            const unsigned m = A._limbs.size() - n;
+            // the normalised operands live in the arena, only the quotient
+            // and the remainder are allocated from the heap
+            Arena& arena = Arena::local();
+            Arena::Mark mark(arena);
 
-            B._limbs.insert(B._limbs.begin(), m, 0);
+            Limb* __restrict b = arena.alloc<Limb>(n);
+            lshift(b, d._limbs.data(), n, k);
 
-            _limbs.clear();
-            if (A >= B) {
-                _limbs.resize(m + 1, 0);
-                _limbs[m] = 1;
-                A -= B;
-            } else {
-                _limbs.resize(m, 0);
+            Limb* __restrict a = arena.alloc<Limb>(m + n + 1);
+            a[m + n] = lshift(a, _limbs.data(), m + n, k);
+
+            const Limb2 b1 = b[n - 1];
+            const Limb2 b2 = b[n - 2];
+
+            Limbs q(m + 1);
+
+            for (unsigned jj = 0; jj <= m; ++jj) {
+                const unsigned j = m - jj;
+
+                // estimate the quotient digit from the leading limbs; the
+                // estimate is at most one too large after the correction
+                const Limb2 t = (static_cast<Limb2>(a[j + n]) << LIMB_BITS) |
+                                a[j + n - 1];
+                Limb2 qhat = t / b1;
+                Limb2 rhat = t % b1;
+
+                while (qhat >= BASE ||
+                       qhat * b2 > ((rhat << LIMB_BITS) | a[j + n - 2])) {
+                    qhat -= 1;
+                    rhat += b1;
+                    if (rhat >= BASE)
+                        break;
+                }
+
+                // a[j..j+n] -= qhat * b
+                Limb carry = 0;
+                Limb borrow = 0;
+
+                for (unsigned i = 0; i < n; ++i) {
+                    const Limb2 p = qhat * b[i] + carry;
+                    carry = static_cast<Limb>(p >> LIMB_BITS);
+                    const Limb2 v = static_cast<Limb2>(a[i + j]) -
+                                    static_cast<Limb>(p) - borrow;
+                    a[i + j] = static_cast<Limb>(v);
+                    borrow = (v >> LIMB_BITS) != 0;
+                }
+
+                const Limb2 v = static_cast<Limb2>(a[j + n]) - carry - borrow;
+                a[j + n] = static_cast<Limb>(v);
+
+                if (v >> LIMB_BITS) {
+                    // the estimate was one too large, add b back
+                    qhat -= 1;
+                    carry = 0;
+                    for (unsigned i = 0; i < n; ++i) {
+                        const Limb2 w =
+                            static_cast<Limb2>(a[i + j]) + b[i] + carry;
+                        a[i + j] = static_cast<Limb>(w);
+                        carry = static_cast<Limb>(w >> LIMB_BITS);
+                    }
+                    a[j + n] += carry;
+                }
+
+                q[j] = static_cast<Limb>(qhat);
             }
 
-            if (A.is_zero()) {
-                drop_zeros();
-                return ZERO;
+            _limbs = std::move(q);
+            drop_zeros();
+
+            NN r;
+            r._limbs.resize(n);
+            rshift(r._limbs.data(), a, n, k);
+            r.drop_zeros();
+
+            return r;
+        }
+
+        // Recursive division (Burnikel and Ziegler). The divisor is
+        // normalised so that its bit length is a multiple of the limb size,
+        // the dividend is cut into chunks of that length and each chunk is
+        // divided with div_2n1n.
+        NN NN::div_rem_dc(const NN& d)
+        {
+            const unsigned k = clz(d._limbs.back());
+
+            NN B(d);
+            B.shift_left(k);
+
+            NN A(*this);
+            A.shift_left(k);
+
+            const unsigned nb = B._limbs.size();
+            const unsigned na = A._limbs.size();
+            const unsigned nd = (na + nb - 1) / nb;
+
+            _limbs.assign(nd * nb, 0);
+
+            NN r;
+
+            for (unsigned ii = 0; ii < nd; ++ii) {
+                const unsigned i = nd - 1 - ii;
+
+                // r <- r * 2^(nb * LIMB_BITS) + i-th chunk of A
+                r._limbs.insert(r._limbs.begin(),
+                                A._limbs.begin() + i * nb,
+                                A._limbs.begin() + std::min((i + 1) * nb, na));
+                r.drop_zeros();
+
+                NN q;
+                div_2n1n(r, B, nb * LIMB_BITS, q, r);
+
+                assert(q._limbs.size() <= nb);
+
+                std::copy(q._limbs.begin(),
+                          q._limbs.end(),
+                          _limbs.begin() + i * nb);
             }
 
-            const Limb B_leading_digit = B._limbs.back();
+            drop_zeros();
 
-            for (unsigned jj = 0; jj < m; ++jj) {
-                const unsigned j = m - 1 - jj;
+            r.shift_right(k);
 
-                Limb2 qs = 0;
-                if (n + j < A._limbs.size()) {
-                    qs = A._limbs[n + j];
-                    qs <<= LIMB_BITS;
+            return r;
+        }
 
-                    if (n + j < A._limbs.size() + 1)
-                        qs += A._limbs[n + j - 1];
+        // a < b * 2^n, b has exactly n bits
+        void NN::div_2n1n(NN a, const NN& b, unsigned long n, NN& q, NN& r)
+        {
+            if (n < DIV_REM_DC_THRESHOLD * LIMB_BITS || b._limbs.size() < 2) {
+                if (b._limbs.size() == 1) {
+                    r = NN(a.div_rem(b._limbs.front()));
+                    q = std::move(a);
+                } else {
+                    r = a.div_rem_bc(b);
+                    q = std::move(a);
                 }
+                return;
+            }
 
-                qs /= B_leading_digit;
+            const bool pad = n & 1;
 
-                _limbs[j] = std::min(qs, static_cast<Limb2>(LIMB_MAX));
+            NN bb(b);
 
-                NN T;
+            if (pad) {
+                a.shift_left(1);
+                bb.shift_left(1);
+                n += 1;
+            }
 
-                for (;;) {
-                    T._limbs.assign(B._limbs.begin() + jj + 1, B._limbs.end());
-                    T *= _limbs[j];
+            const unsigned long h = n / 2;
 
-                    if (A >= T)
-                        break;
+            NN b1(bb);
+            b1.shift_right(h);
+            const NN b2 = bb.low_bits(h);
 
-                    _limbs[j] -= 1;
-                }
+            NN a1(a);
+            a1.shift_right(n);
 
-                A -= T;
+            NN a2(a);
+            a2.shift_right(h);
+            a2 = a2.low_bits(h);
+
+            NN q1;
+            div_3n2n(a1, a2, bb, b1, b2, h, q1, r);
+            div_3n2n(r, a.low_bits(h), bb, b1, b2, h, q, r);
+
+            if (pad)
+                r.shift_right(1);
+
+            q1.shift_left(h);
+            q.add(q1);
+        }
+
+        // a12 < b * 2^n, b = b1 * 2^n + b2, b1 has exactly n bits
+        void NN::div_3n2n(const NN& a12,
+                          const NN& a3,
+                          const NN& b,
+                          const NN& b1,
+                          const NN& b2,
+                          unsigned long n,
+                          NN& q,
+                          NN& r)
+        {
+            NN t(a12);
+            t.shift_right(n);
+
+            if (t == b1) {
+                // q <- 2^n - 1, r <- a12 - b1 * 2^n + b1
+                q = ONE;
+                q.shift_left(n);
+                q.sub(1);
+
+                t = b1;
+                t.shift_left(n);
+
+                r = a12;
+                r.add(b1);
+                r.sub(t);
+            } else {
+                div_2n1n(a12, b1, n, q, r);
             }
 
-            drop_zeros();
+            // r <- r * 2^n + a3 - q * b2
+            r.shift_left(n);
+            r.add(a3);
 
-            A >>= k;
+            t = q;
+            t.mul(b2);
 
-            return A;
+            while (r < t) {
+                q.sub(1);
+                r.add(b);
+            }
+
+            r.sub(t);
         }
 
-        NN gcd(NN a, NN b)
+        NN NN::low_bits(unsigned long n) const
         {
-            NN t;
+            const unsigned long nl = n / LIMB_BITS;
+            const unsigned nb = n % LIMB_BITS;
+
+            if (nl >= _limbs.size())
+                return *this;
+
+            NN r(_limbs.begin(), _limbs.begin() + nl + (nb ? 1 : 0));
 
-            while (!b.is_zero()) {
-                t = b;
-                b = a;
-                b %= t;
-                a = t;
+            if (nb && r._limbs.size() == nl + 1) {
+                r._limbs.back() &= (static_cast<Limb>(1) << nb) - 1;
+                r.drop_zeros();
             }
 
-            return a;
+            return r;
         }
     }
 }
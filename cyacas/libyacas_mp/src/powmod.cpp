@@ -0,0 +1,385 @@
+/*
+ *
+ * This file is part of yacas.
+ * Yacas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesset General Public License as
+ * published by the Free Software Foundation, either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * Yacas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with yacas.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "yacas/mp/zz.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <vector>
+
+// Modular exponentiation by left-to-right sliding windows.
+//
+// Odd moduli are handled in Montgomery representation, a -> a R mod m with
+// R = 2^(LIMB_BITS n) for an n-limb modulus, so that no division is needed
+// in the main loop. Below POWMOD_REDC_THRESHOLD limbs the product and the
+// reduction are interleaved limb by limb (CIOS); above that the reduction is
+// done with two further multiplications to benefit from the subquadratic
+// ones. Even moduli fall back to multiplication followed by division.
+
+namespace {
+    using namespace yacas::mp;
+
+    typedef NN::Limb Limb;
+    typedef NN::Limb2 Limb2;
+
+    static constexpr int LIMB_BITS = sizeof(Limb) * CHAR_BIT;
+
+    // -m^-1 mod 2^LIMB_BITS for odd m
+    Limb neg_inverse(Limb m)
+    {
+        // correct to 3 bits, each Newton step doubles that
+        Limb x = m;
+        for (int i = 3; i < LIMB_BITS; i *= 2)
+            x *= 2 - m * x;
+
+        return 0 - x;
+    }
+
+    class MontgomeryCIOS {
+    public:
+        typedef std::vector<Limb> Residue;
+
+        explicit MontgomeryCIOS(const NN& m) :
+            _mm(m),
+            _m(m.raw_limbs().begin(), m.raw_limbs().end()),
+            _n(_m.size()),
+            _minv(neg_inverse(_m[0])),
+            _t(_n + 2)
+        {
+        }
+
+        Residue to(const NN& a) const
+        {
+            NN t(a);
+            t <<= _n * LIMB_BITS;
+            t %= _mm;
+
+            Residue r(_n, 0);
+            std::copy(t.raw_limbs().begin(), t.raw_limbs().end(), r.begin());
+
+            return r;
+        }
+
+        NN from(Residue a)
+        {
+            Residue one(_n, 0);
+            one[0] = 1;
+            mul(a, one);
+
+            return NN(a);
+        }
+
+        void sqr(Residue& a) { mul(a, a); }
+
+        void mul(Residue& a, const Residue& b)
+        {
+            const unsigned n = _n;
+            const Limb* __restrict m = _m.data();
+            Limb* __restrict t = _t.data();
+
+            std::fill(_t.begin(), _t.end(), 0);
+
+            for (unsigned i = 0; i < n; ++i) {
+                const Limb bi = b[i];
+
+                Limb c = 0;
+                for (unsigned j = 0; j < n; ++j) {
+                    const Limb2 v = static_cast<Limb2>(a[j]) * bi + t[j] + c;
+                    t[j] = static_cast<Limb>(v);
+                    c = static_cast<Limb>(v >> LIMB_BITS);
+                }
+
+                Limb2 v = static_cast<Limb2>(t[n]) + c;
+                t[n] = static_cast<Limb>(v);
+                t[n + 1] = static_cast<Limb>(v >> LIMB_BITS);
+
+                const Limb q = t[0] * _minv;
+
+                v = static_cast<Limb2>(q) * m[0] + t[0];
+                c = static_cast<Limb>(v >> LIMB_BITS);
+                for (unsigned j = 1; j < n; ++j) {
+                    v = static_cast<Limb2>(q) * m[j] + t[j] + c;
+                    t[j - 1] = static_cast<Limb>(v);
+                    c = static_cast<Limb>(v >> LIMB_BITS);
+                }
+
+                v = static_cast<Limb2>(t[n]) + c;
+                t[n - 1] = static_cast<Limb>(v);
+                t[n] = t[n + 1] + static_cast<Limb>(v >> LIMB_BITS);
+            }
+
+            // t < 2 m, subtract m once if needed
+            bool ge = t[n] != 0;
+            if (!ge) {
+                ge = true;
+                for (unsigned j = n; j-- > 0;)
+                    if (t[j] != m[j]) {
+                        ge = t[j] > m[j];
+                        break;
+                    }
+            }
+
+            if (ge) {
+                Limb borrow = 0;
+                for (unsigned j = 0; j < n; ++j) {
+                    const Limb2 v = static_cast<Limb2>(t[j]) - m[j] - borrow;
+                    a[j] = static_cast<Limb>(v);
+                    borrow = (v >> LIMB_BITS) != 0;
+                }
+            } else {
+                std::copy(t, t + n, a.begin());
+            }
+        }
+
+    private:
+        const NN _mm;
+        const std::vector<Limb> _m;
+        const unsigned _n;
+        const Limb _minv;
+        std::vector<Limb> _t;
+    };
+
+    class MontgomeryREDC {
+    public:
+        typedef NN Residue;
+
+        explicit MontgomeryREDC(const NN& m) :
+            _m(m),
+            _bits(m.raw_limbs().size() * LIMB_BITS)
+        {
+            // m^-1 mod R by Newton iteration x <- x (2 - m x)
+            NN x(0 - neg_inverse(m.raw_limbs().front()));
+
+            for (unsigned long p = LIMB_BITS; p < _bits;) {
+                p = std::min(2 * p, _bits);
+
+                NN e = m.low_bits(p);
+                e *= x;
+                e = e.low_bits(p);
+
+                NN t(NN::ONE);
+                t <<= p;
+                t += 2;
+                t -= e;
+
+                x *= t;
+                x = x.low_bits(p);
+            }
+
+            _minv = NN::ONE;
+            _minv <<= _bits;
+            _minv -= x;
+        }
+
+        Residue to(const NN& a) const
+        {
+            NN t(a);
+            t <<= _bits;
+            t %= _m;
+            return t;
+        }
+
+        NN from(Residue a) const
+        {
+            redc(a);
+            return a;
+        }
+
+        void sqr(Residue& a) const
+        {
+            a.sqr();
+            redc(a);
+        }
+
+        void mul(Residue& a, const Residue& b) const
+        {
+            a *= b;
+            redc(a);
+        }
+
+    private:
+        const NN _m;
+        const unsigned long _bits;
+        NN _minv;
+
+        // t R^-1 mod m for t < m R
+        void redc(NN& t) const
+        {
+            NN q = t.low_bits(_bits);
+            q *= _minv;
+            q = q.low_bits(_bits);
+            q *= _m;
+
+            t += q;
+            t >>= _bits;
+
+            if (t >= _m)
+                t -= _m;
+        }
+    };
+
+    class Division {
+    public:
+        typedef NN Residue;
+
+        explicit Division(const NN& m) : _m(m) {}
+
+        Residue to(const NN& a) const { return a; }
+        NN from(const Residue& a) const { return a; }
+
+        void sqr(Residue& a) const
+        {
+            a.sqr();
+            a %= _m;
+        }
+
+        void mul(Residue& a, const Residue& b) const
+        {
+            a *= b;
+            a %= _m;
+        }
+
+    private:
+        const NN _m;
+    };
+
+    unsigned window_size(unsigned long exponent_bits)
+    {
+        static const unsigned long limits[] = {8, 24, 80, 240, 672, 1792};
+
+        unsigned k = 1;
+        for (unsigned long l : limits) {
+            if (exponent_bits <= l)
+                break;
+            k += 1;
+        }
+
+        return k;
+    }
+
+    // b^e for b reduced and e > 0
+    template <class Ring> NN powmod(Ring& ring, const NN& b, const NN& e)
+    {
+        typedef typename Ring::Residue Residue;
+
+        const unsigned long n = e.no_bits();
+        const unsigned k = window_size(n);
+
+        // odd powers b, b^3, ..., b^(2^k - 1)
+        std::vector<Residue> table(1u << (k - 1));
+        table[0] = ring.to(b);
+        if (k > 1) {
+            Residue b2 = table[0];
+            ring.sqr(b2);
+            for (std::size_t i = 1; i < table.size(); ++i) {
+                table[i] = table[i - 1];
+                ring.mul(table[i], b2);
+            }
+        }
+
+        Residue r;
+        bool started = false;
+
+        for (long i = n - 1; i >= 0;) {
+            if (!e.test(i)) {
+                ring.sqr(r);
+                i -= 1;
+                continue;
+            }
+
+            long l = std::max(i - static_cast<long>(k) + 1, 0l);
+            while (!e.test(l))
+                l += 1;
+
+            unsigned u = 0;
+            for (long j = i; j >= l; --j)
+                u = 2 * u + e.test(j);
+
+            if (started) {
+                for (long j = l; j <= i; ++j)
+                    ring.sqr(r);
+                ring.mul(r, table[u / 2]);
+            } else {
+                r = table[u / 2];
+                started = true;
+            }
+
+            i = l - 1;
+        }
+
+        return ring.from(r);
+    }
+}
+
+namespace yacas {
+    namespace mp {
+        NN powmod(const NN& b, const NN& e, const NN& m)
+        {
+            if (m.is_zero())
+                throw NN::DivisionByZeroError(b.to_string());
+
+            if (m == 1)
+                return NN();
+
+            if (e.is_zero())
+                return NN::ONE;
+
+            NN a(b);
+            if (a >= m)
+                a %= m;
+
+            if (a.is_zero())
+                return a;
+
+            if (m.is_even()) {
+                Division ring(m);
+                return ::powmod(ring, a, e);
+            }
+
+            if (m.raw_limbs().size() < NN::POWMOD_REDC_THRESHOLD) {
+                MontgomeryCIOS ring(m);
+                return ::powmod(ring, a, e);
+            }
+
+            MontgomeryREDC ring(m);
+            return ::powmod(ring, a, e);
+        }
+
+        ZZ powmod(const ZZ& b, const ZZ& e, const ZZ& m)
+        {
+            if (m.is_zero())
+                throw ZZ::DivisionByZeroError(b.to_string());
+
+            if (m.is_negative())
+                throw std::domain_error(
+                    "yacas::mp::powmod: negative modulus " + m.to_string());
+
+            if (e.is_negative())
+                throw std::domain_error(
+                    "yacas::mp::powmod: negative exponent " + e.to_string());
+
+            ZZ a(b);
+            a %= m;
+            if (a.is_negative())
+                a += m;
+
+            return ZZ(powmod(a.to_NN(), e.to_NN(), m.to_NN()));
+        }
+    }
+}
@@ -0,0 +1,308 @@
+/*
+ *
+ * This file is part of yacas.
+ * Yacas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesset General Public License as
+ * published by the Free Software Foundation, either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * Yacas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with yacas.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "yacas/mp/nn.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+
+// Integer roots by Newton's iteration. Started above the root, the integer
+// iteration x <- ((k - 1) x + a / x^(k - 1)) / k decreases monotonically
+// to floor(a^(1/k)) and never goes below it. The starting point is the
+// root of the leading half of the digits, computed recursively, so that
+// one or two steps at full precision suffice.
+
+namespace {
+    using namespace yacas::mp;
+
+    typedef NN::Limb Limb;
+    typedef NN::Limb2 Limb2;
+
+    static constexpr int LIMB_BITS = sizeof(Limb) * CHAR_BIT;
+
+    unsigned bit_length(unsigned long n)
+    {
+        unsigned l = 0;
+        while (n) {
+            n >>= 1;
+            l += 1;
+        }
+        return l;
+    }
+
+    // log2(a) for a > 0, from its leading limbs
+    double log2(const NN& a)
+    {
+        const NN::Limbs& l = a.raw_limbs();
+        const std::size_t n = l.size();
+        const std::size_t m = std::min<std::size_t>(n, 128 / LIMB_BITS);
+
+        double t = 0;
+        for (std::size_t i = n; i-- > n - m;)
+            t = std::ldexp(t, LIMB_BITS) + l[i];
+
+        return std::log2(t) + (n - m) * LIMB_BITS;
+    }
+
+    // a mod q for q > 0
+    Limb mod_1(const NN& a, Limb q)
+    {
+        const NN::Limbs& l = a.raw_limbs();
+
+        Limb r = 0;
+        for (std::size_t i = l.size(); i-- > 0;)
+            r = ((static_cast<Limb2>(r) << LIMB_BITS) | l[i]) % q;
+
+        return r;
+    }
+
+    // b^e mod q for q < 2^32
+    std::uint64_t powmod_1(std::uint64_t b, std::uint64_t e, std::uint64_t q)
+    {
+        std::uint64_t r = 1;
+
+        for (b %= q; e; e >>= 1) {
+            if (e & 1)
+                r = r * b % q;
+            b = b * b % q;
+        }
+
+        return r;
+    }
+
+    bool is_prime_1(std::uint64_t n)
+    {
+        if (n < 2)
+            return false;
+
+        for (std::uint64_t d = 2; d * d <= n; ++d)
+            if (n % d == 0)
+                return false;
+
+        return true;
+    }
+
+    // Whether a may be a p-th power as far as a few primes q = 1 mod p can
+    // tell. For a = x^p, a^((q - 1) / p) = 1 mod q unless q divides a,
+    // while otherwise this holds with probability 1 / p only.
+    bool may_be_power(const NN& a, unsigned p)
+    {
+        constexpr unsigned TESTS = 4;
+
+        unsigned tests = 0;
+        for (std::uint64_t q = 2 * p + 1; tests < TESTS && q < (1u << 31); q += 2 * p) {
+            if (!is_prime_1(q))
+                continue;
+
+            tests += 1;
+
+            const Limb r = mod_1(a, static_cast<Limb>(q));
+            if (r != 0 && powmod_1(r, (q - 1) / p, q) != 1)
+                return false;
+        }
+
+        return true;
+    }
+
+    // floor(a^(1/k)) for a > 0, k > 1, starting from x >= that
+    NN newton(const NN& a, unsigned k, NN x)
+    {
+        for (;;) {
+            NN p(x);
+            p.pow(k - 1);
+
+            NN t(p);
+            t *= x;
+
+            if (t <= a)
+                return x;
+
+            // x <- ((k - 1) x + a / x^(k - 1)) / k
+            NN q(a);
+            q /= p;
+
+            x *= k - 1;
+            x += q;
+            x /= k;
+        }
+    }
+
+    // a little above a^(1/k), which has rb bits, from a double; the
+    // rounding errors are well below the relative 2^-40 added
+    NN estimate(const NN& a, unsigned k, unsigned long rb)
+    {
+        const unsigned long s = rb > 52 ? rb - 52 : 0;
+        const double m =
+            std::exp2(log2(a) / k - s) * (1 + std::ldexp(1.0, -40)) + 2;
+        const std::uint64_t v = static_cast<std::uint64_t>(m);
+
+        NN x(static_cast<Limb>(v >> 32));
+        x <<= 32;
+        x += static_cast<Limb>(v & 0xffffffff);
+        x <<= s;
+
+        return x;
+    }
+
+    NN root(const NN& a, unsigned k)
+    {
+        const unsigned long b = a.no_bits();
+
+        // bits in the root, and guard bits against the error of Newton's
+        // step growing with k
+        const unsigned long rb = (b + k - 1) / k;
+        const unsigned long g = bit_length(k) + 2;
+
+        if (rb <= std::max(52ul, 2 * g + 2))
+            return newton(a, k, estimate(a, k, rb));
+
+        // the root of the leading digits gives the leading rb - s bits
+        const unsigned long s = rb / 2 - g;
+
+        NN h(a);
+        h >>= k * s;
+
+        // above the root: ((r + 1) 2^s)^k > (h + 1) 2^(k s) > a
+        NN x = root(h, k);
+        x += 1;
+        x <<= s;
+
+        return newton(a, k, std::move(x));
+    }
+}
+
+namespace yacas {
+    namespace mp {
+        // Each step doubles the number of correct leading bits of a, with a
+        // division of the size reached so far (the algorithm of Python's
+        // math.isqrt).
+        void NN::isqrt()
+        {
+            if (_limbs.size() <= 1) {
+                const Limb n = _limbs.empty() ? 0 : _limbs[0];
+                Limb r = static_cast<Limb>(std::sqrt(static_cast<double>(n)));
+
+                while (static_cast<Limb2>(r) * r > n)
+                    r -= 1;
+                while (static_cast<Limb2>(r + 1) * (r + 1) <= n)
+                    r += 1;
+
+                *this = NN(r);
+                return;
+            }
+
+            const unsigned long c = (no_bits() - 1) / 2;
+
+            NN a(ONE);
+            unsigned long d = 0;
+
+            for (unsigned s = bit_length(c); s-- > 0;) {
+                const unsigned long e = d;
+                d = c >> s;
+
+                // a <- a 2^(d - e - 1) + (n / 2^(2 c - e - d + 1)) / a
+                NN q(*this);
+                q >>= 2 * c - e - d + 1;
+                q /= a;
+
+                a <<= d - e - 1;
+                a += q;
+            }
+
+            NN t(a);
+            t.sqr();
+
+            if (t > *this)
+                a -= 1;
+
+            *this = std::move(a);
+        }
+
+        void NN::iroot(unsigned k)
+        {
+            assert(k > 0);
+
+            if (k == 1 || is_zero())
+                return;
+
+            if (k == 2) {
+                isqrt();
+                return;
+            }
+
+            // a < 2^k, so the root is 1
+            if (k >= no_bits()) {
+                *this = ONE;
+                return;
+            }
+
+            *this = root(*this, k);
+        }
+
+        // Prime exponents p are tried in increasing order; a p-th power has
+        // a number of trailing zero bits divisible by p, and most of the
+        // others fail the modular test. A root found is tried again from p
+        // on, so that the exponents multiply up to the largest.
+        bool NN::is_perfect_power(NN& r, unsigned& k) const
+        {
+            r = *this;
+            k = 1;
+
+            if (*this <= ONE)
+                return false;
+
+            unsigned long zeros = 0;
+            while (!r.test(zeros))
+                zeros += 1;
+
+            for (unsigned p = 2; p <= r.no_bits();) {
+                if (!is_prime_1(p) || (zeros && zeros % p) || !may_be_power(r, p)) {
+                    p += 1;
+                    continue;
+                }
+
+                NN x(r);
+                x.iroot(p);
+
+                NN t(x);
+                t.pow(p);
+
+                if (t != r) {
+                    p += 1;
+                    continue;
+                }
+
+                r = std::move(x);
+                k *= p;
+                zeros /= p;
+            }
+
+            return k > 1;
+        }
+
+        bool NN::is_perfect_power() const
+        {
+            NN r;
+            unsigned k;
+            return is_perfect_power(r, k);
+        }
+    }
+}
@@ -0,0 +1,171 @@
+/*
+ *
+ * This file is part of yacas.
+ * Yacas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesset General Public License as
+ * published by the Free Software Foundation, either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * Yacas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with yacas.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "yacas/mp/thread_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace {
+    // the pool the calling thread works for, if any, and its queue there
+    thread_local const yacas::mp::ThreadPool* worker_pool = nullptr;
+    thread_local unsigned worker_index = 0;
+}
+
+namespace yacas {
+    namespace mp {
+        ThreadPool::ThreadPool(unsigned n) :
+            _queues(new Queue[std::max(n, 1u)]),
+            _queued(0),
+            _waiting(0),
+            _stop(false)
+        {
+            for (unsigned i = 1; i < n; ++i)
+                _workers.emplace_back(&ThreadPool::work, this, i);
+        }
+
+        ThreadPool::~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+
+            _wake.notify_all();
+
+            for (std::thread& t : _workers)
+                t.join();
+
+            assert(_queued == 0);
+        }
+
+        unsigned ThreadPool::size() const
+        {
+            return _workers.size() + 1;
+        }
+
+        unsigned ThreadPool::index() const
+        {
+            return worker_pool == this ? worker_index : 0;
+        }
+
+        void ThreadPool::push(Task* t)
+        {
+            Queue& q = _queues[index()];
+
+            {
+                std::lock_guard<std::mutex> lock(q.mutex);
+                q.tasks.push_back(t);
+            }
+
+            _queued.fetch_add(1);
+
+            // a worker about to go to sleep either sees the task or gets
+            // woken up
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+            }
+
+            _wake.notify_one();
+        }
+
+        // the newest task of the own queue, or else the oldest one of
+        // another queue
+        ThreadPool::Task* ThreadPool::pop()
+        {
+            if (_queued.load() == 0)
+                return nullptr;
+
+            const unsigned n = size();
+            const unsigned self = index();
+
+            for (unsigned i = 0; i < n; ++i) {
+                Queue& q = _queues[(self + i) % n];
+
+                std::lock_guard<std::mutex> lock(q.mutex);
+
+                if (q.tasks.empty())
+                    continue;
+
+                Task* t;
+                if (i == 0) {
+                    t = q.tasks.back();
+                    q.tasks.pop_back();
+                } else {
+                    t = q.tasks.front();
+                    q.tasks.pop_front();
+                }
+
+                _queued.fetch_sub(1);
+
+                return t;
+            }
+
+            return nullptr;
+        }
+
+        void ThreadPool::run(Task* t)
+        {
+            t->run();
+
+            // t may be gone by now, its waiter having seen it done
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (_waiting)
+                _wake.notify_all();
+        }
+
+        // Run queued tasks until the task is done; with none to be had,
+        // sleep until it is done or another one is queued.
+        void ThreadPool::wait(Task& task)
+        {
+            while (!task.done()) {
+                if (Task* t = pop()) {
+                    run(t);
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(_mutex);
+                _waiting += 1;
+                _wake.wait(lock, [this, &task] {
+                    return task.done() || _queued.load() > 0;
+                });
+                _waiting -= 1;
+            }
+        }
+
+        void ThreadPool::work(unsigned i)
+        {
+            worker_pool = this;
+            worker_index = i;
+
+            for (;;) {
+                if (Task* t = pop()) {
+                    run(t);
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait(lock, [this] { return _stop || _queued.load() > 0; });
+
+                if (_stop)
+                    return;
+            }
+        }
+    }
+}
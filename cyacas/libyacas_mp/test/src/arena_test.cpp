@@ -0,0 +1,120 @@
+/*
+ *
+ * This file is part of yacas.
+ * Yacas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesset General Public License as
+ * published by the Free Software Foundation, either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * Yacas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with yacas.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "yacas/mp/arena.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace yacas::mp;
+
+TEST(YMP_ArenaTest, alignment)
+{
+    Arena arena;
+    Arena::Mark mark(arena);
+
+    for (std::size_t n = 1; n < 20; ++n) {
+        const char* p = arena.alloc<char>(n);
+        ASSERT_EQ(reinterpret_cast<std::uintptr_t>(p) % alignof(std::max_align_t), 0);
+    }
+}
+
+TEST(YMP_ArenaTest, mark_release)
+{
+    Arena arena;
+
+    unsigned* p = nullptr;
+    {
+        Arena::Mark mark(arena);
+        p = arena.alloc<unsigned>(100);
+        std::fill(p, p + 100, 1);
+
+        unsigned* q = nullptr;
+        {
+            Arena::Mark inner(arena);
+            q = arena.alloc<unsigned>(100);
+            ASSERT_NE(p, q);
+            std::fill(q, q + 100, 2);
+        }
+
+        ASSERT_TRUE(std::all_of(p, p + 100, [](unsigned v) { return v == 1; }));
+
+        // the memory of the inner mark is handed out again
+        ASSERT_EQ(arena.alloc<unsigned>(100), q);
+    }
+
+    Arena::Mark mark(arena);
+    ASSERT_EQ(arena.alloc<unsigned>(100), p);
+}
+
+TEST(YMP_ArenaTest, growth)
+{
+    Arena arena;
+
+    std::size_t total = 0;
+    {
+        Arena::Mark mark(arena);
+        for (int i = 0; i < 64; ++i) {
+            unsigned char* p = arena.alloc<unsigned char>(10000);
+            std::fill(p, p + 10000, static_cast<unsigned char>(i));
+            total += 10000;
+        }
+        ASSERT_GE(arena.capacity(), total);
+    }
+
+    // the blocks are merged into one big enough for the whole lot
+    const std::size_t capacity = arena.capacity();
+    ASSERT_GE(capacity, total);
+
+    {
+        Arena::Mark mark(arena);
+        const unsigned char* first = arena.alloc<unsigned char>(10000);
+        for (int i = 1; i < 64; ++i)
+            ASSERT_EQ(arena.alloc<unsigned char>(10000), first + i * 10000);
+    }
+
+    ASSERT_EQ(arena.capacity(), capacity);
+}
+
+TEST(YMP_ArenaTest, large)
+{
+    Arena arena;
+
+    {
+        Arena::Mark mark(arena);
+        arena.alloc<char>(64 * 1024 * 1024);
+    }
+
+    // huge blocks are not kept
+    const std::size_t capacity = arena.capacity();
+    ASSERT_LT(capacity, 64 * 1024 * 1024);
+
+    {
+        Arena::Mark mark(arena);
+        arena.alloc<char>(64 * 1024 * 1024);
+    }
+
+    ASSERT_EQ(arena.capacity(), capacity);
+}
+
+TEST(YMP_ArenaTest, local)
+{
+    ASSERT_EQ(&Arena::local(), &Arena::local());
+}
@@ -20,8 +20,56 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
 using namespace yacas::mp;
 
+namespace {
+    // Restores the thresholds and the number of threads when a test that
+    // changes them ends, also when a failed assertion ends it early.
+    class SavedThresholds {
+    public:
+        SavedThresholds() : _threads(NN::threads())
+        {
+            for (std::size_t i = 0; i < N; ++i)
+                _values[i] = *thresholds[i];
+        }
+
+        ~SavedThresholds()
+        {
+            for (std::size_t i = 0; i < N; ++i)
+                *thresholds[i] = _values[i];
+
+            if (NN::threads() != _threads)
+                NN::set_threads(_threads);
+        }
+
+        SavedThresholds(const SavedThresholds&) = delete;
+        SavedThresholds& operator=(const SavedThresholds&) = delete;
+
+    private:
+        static constexpr std::size_t N = 11;
+
+        static constexpr unsigned* thresholds[N] = {
+            &NN::PARSE_DC_THRESHOLD,
+            &NN::TO_STRING_DC_THRESHOLD,
+            &NN::DIV_REM_DC_THRESHOLD,
+            &NN::GCD_DC_THRESHOLD,
+            &NN::HGCD_THRESHOLD,
+            &NN::POWMOD_REDC_THRESHOLD,
+            &NN::FACTORIAL_SWING_THRESHOLD,
+            &NN::MUL_TOOM22_THRESHOLD,
+            &NN::MUL_TOOM33_THRESHOLD,
+            &NN::MUL_FFT_THRESHOLD,
+            &NN::MUL_THREADS_THRESHOLD};
+
+        unsigned _values[N];
+        unsigned _threads;
+    };
+}
+
 TEST(YMP_NNTest, construction)
 {
     ASSERT_TRUE(NN("0").is_zero());
@@ -35,6 +83,18 @@ TEST(YMP_NNTest, construction)
     ASSERT_THROW(NN("deadbeef", 15), NN::ParseError);
 }
 
+TEST(YMP_NNTest, limbs)
+{
+    const NN a("123456789012345678901234567890");
+
+    const std::vector<NN::Limb> l = a.limbs();
+    ASSERT_EQ(l.size(), a.raw_limbs().size());
+    ASSERT_TRUE(std::equal(l.begin(), l.end(), a.raw_limbs().begin()));
+    ASSERT_EQ(NN(l), a);
+
+    ASSERT_TRUE(NN::ZERO.limbs().empty());
+}
+
 TEST(YMP_NNTest, is_zero)
 {
     ASSERT_TRUE(NN(0u).is_zero());
@@ -78,6 +138,81 @@ TEST(YMP_NNTest, to_string)
         "121932631356500531591068431703703700581771069347203169112635269");
 }
 
+TEST(YMP_NNTest, to_string_dc)
+{
+    std::mt19937 rng(42);
+
+    const SavedThresholds saved;
+
+    const unsigned parse_threshold = NN::PARSE_DC_THRESHOLD;
+    const unsigned to_string_threshold = NN::TO_STRING_DC_THRESHOLD;
+
+    for (unsigned bits : {100u, 1000u, 4321u, 20000u}) {
+        NN a(bits, rng);
+
+        // long runs of zero digits and of zero limbs
+        NN b(1u);
+        b <<= bits;
+        b += 1;
+
+        for (const NN& x : {a, b}) {
+            for (unsigned base : {2u, 3u, 10u, 16u, 36u}) {
+                NN::PARSE_DC_THRESHOLD = 1u << 30;
+                NN::TO_STRING_DC_THRESHOLD = 1u << 30;
+
+                const std::string s = x.to_string(base);
+
+                NN::PARSE_DC_THRESHOLD = 1;
+                NN::TO_STRING_DC_THRESHOLD = 3;
+
+                ASSERT_EQ(x.to_string(base), s);
+                ASSERT_EQ(NN(s, base), x);
+                ASSERT_EQ(NN("000000000000000000000" + s, base), x);
+            }
+        }
+    }
+
+    NN::PARSE_DC_THRESHOLD = parse_threshold;
+    NN::TO_STRING_DC_THRESHOLD = to_string_threshold;
+
+    ASSERT_EQ(NN(std::string(5000, '0')), NN::ZERO);
+    ASSERT_EQ(NN("1" + std::string(5000, '0')).to_string(), "1" + std::string(5000, '0'));
+    ASSERT_THROW(NN(std::string(5000, '1') + "a"), NN::ParseError);
+}
+
+TEST(YMP_NNTest, to_string_pow2)
+{
+    std::mt19937 rng(42);
+
+    ASSERT_EQ(NN("DEADBEEF", 16), NN("3735928559"));
+    ASSERT_EQ(NN("11111111111111111111111111111111", 2).to_string(16), "ffffffff");
+    ASSERT_EQ(NN("100000000000000000000000000000000", 2).to_string(32), "4000000");
+
+    for (unsigned bits : {1u, 31u, 32u, 33u, 64u, 65u, 1000u, 4321u}) {
+        const NN a(bits, rng);
+        const std::string s2 = a.to_string(2);
+
+        ASSERT_EQ(s2.size(), a.no_bits());
+        ASSERT_EQ(NN(s2, 2), a);
+
+        for (unsigned k = 1; k <= 5; ++k) {
+            // regroup the binary digits k at a time
+            std::string t(s2);
+            t.insert(0, (k - t.size() % k) % k, '0');
+
+            std::string s;
+            for (std::size_t i = 0; i < t.size(); i += k) {
+                const unsigned d = std::stoul(t.substr(i, k), nullptr, 2);
+                s += d <= 9 ? '0' + d : 'a' + d - 10;
+            }
+
+            ASSERT_EQ(a.to_string(1u << k), s);
+            ASSERT_EQ(NN(s, 1u << k), a);
+            ASSERT_EQ(NN("000" + s, 1u << k), a);
+        }
+    }
+}
+
 TEST(YMP_NNTest, io)
 {
     std::ostringstream os;
@@ -117,6 +252,17 @@ TEST(YMP_NNTest, shift)
         NN("1950922101704008505457094907259259209308337109555250705802164288"));
 }
 
+TEST(YMP_NNTest, add_sub_carry)
+{
+    NN a("18446744073709551615");
+    NN b("340282366920938463463374607431768211456");
+
+    b -= a;
+    ASSERT_EQ(b, NN("340282366920938463444927863358058659841"));
+    b += a;
+    ASSERT_EQ(b, NN("340282366920938463463374607431768211456"));
+}
+
 TEST(YMP_NNTest, sqr)
 {
     NN a;
@@ -222,6 +368,158 @@ TEST(YMP_NNTest, mul)
         NN("121932631356500531591068431703703700581771069347203169112635269"));
 }
 
+TEST(YMP_NNTest, mul_toom)
+{
+    std::mt19937 rng(42);
+
+    const SavedThresholds saved;
+
+    const unsigned toom22_threshold = NN::MUL_TOOM22_THRESHOLD;
+    const unsigned toom33_threshold = NN::MUL_TOOM33_THRESHOLD;
+
+    const unsigned sizes[][2] = {
+        {1024, 1024}, {1024, 1000}, {2048, 1536}, {3000, 2048}, {4096, 4096},
+        {4096, 1024}, {1024, 9000}, {7000, 6999}, {16384, 1100}, {8192, 8192}};
+
+    for (const auto& s : sizes) {
+        const NN a(s[0], rng);
+        const NN b(s[1], rng);
+
+        NN::MUL_TOOM22_THRESHOLD = toom22_threshold;
+        NN::MUL_TOOM33_THRESHOLD = toom33_threshold;
+
+        NN c(a);
+        c *= b;
+
+        NN d(b);
+        d *= a;
+
+        NN::MUL_TOOM22_THRESHOLD = 1u << 30;
+        NN::MUL_TOOM33_THRESHOLD = 1u << 30;
+
+        NN e(a);
+        e *= b;
+
+        ASSERT_EQ(c, e);
+        ASSERT_EQ(d, e);
+    }
+
+    NN::MUL_TOOM22_THRESHOLD = toom22_threshold;
+    NN::MUL_TOOM33_THRESHOLD = toom33_threshold;
+
+    NN a(1u);
+    a <<= 4000;
+    a -= 1;
+
+    NN b(a);
+    b *= a;
+
+    NN c(a);
+    c.sqr();
+
+    ASSERT_EQ(b, c);
+}
+
+TEST(YMP_NNTest, mul_fft)
+{
+    std::mt19937 rng(42);
+
+    const SavedThresholds saved;
+
+    const unsigned sizes[][2] = {
+        {65536, 65536}, {65536, 60000}, {100000, 33}, {1024, 200000},
+        {131072, 131071}};
+
+    for (const auto& s : sizes) {
+        const NN a(s[0], rng);
+        const NN b(s[1], rng);
+
+        NN::MUL_FFT_THRESHOLD = 2;
+
+        NN c(a);
+        c *= b;
+
+        NN d(a);
+        d.sqr();
+
+        NN::MUL_FFT_THRESHOLD = 1u << 30;
+
+        NN e(a);
+        e *= b;
+
+        NN f(a);
+        f.sqr();
+
+        ASSERT_EQ(c, e);
+        ASSERT_EQ(d, f);
+    }
+
+    NN::MUL_FFT_THRESHOLD = 2;
+
+    NN a(1u);
+    a <<= 100000;
+    a -= 1;
+
+    NN b(a);
+    b *= a;
+
+    NN c(1u);
+    c <<= 200000;
+    c -= a;
+    c -= a;
+    c -= 1;
+
+    ASSERT_EQ(b, c);
+}
+
+TEST(YMP_NNTest, mul_threads)
+{
+    std::mt19937 rng(42);
+
+    const SavedThresholds saved;
+
+    const unsigned threads_threshold = NN::MUL_THREADS_THRESHOLD;
+    const unsigned fft_threshold = NN::MUL_FFT_THRESHOLD;
+
+    const unsigned sizes[][2] = {
+        {40000, 40000}, {40000, 30000}, {300000, 290000}, {1000000, 999999}};
+
+    for (const auto& s : sizes) {
+        const NN a(s[0], rng);
+        const NN b(s[1], rng);
+
+        NN::set_threads(1);
+
+        NN c(a);
+        c *= b;
+
+        NN d(a);
+        d.sqr();
+
+        NN::set_threads(4);
+        ASSERT_EQ(NN::threads(), 4u);
+
+        NN::MUL_THREADS_THRESHOLD = 1;
+
+        // Toom with threads, and a threaded FFT underneath
+        for (unsigned t : {1u << 30, 64u}) {
+            NN::MUL_FFT_THRESHOLD = t;
+
+            NN e(a);
+            e *= b;
+
+            NN f(a);
+            f.sqr();
+
+            ASSERT_EQ(c, e);
+            ASSERT_EQ(d, f);
+        }
+
+        NN::MUL_THREADS_THRESHOLD = threads_threshold;
+        NN::MUL_FFT_THRESHOLD = fft_threshold;
+    }
+}
+
 TEST(YMP_NNTest, pow)
 {
     NN a("1234567890123456789");
@@ -437,6 +735,159 @@ TEST(YMP_NNTest, div_rem)
     ASSERT_EQ(a, NN("18527737155016642260898961793617744820333125"));
 }
 
+TEST(YMP_NNTest, div_rem_dc)
+{
+    std::mt19937 rng(42);
+
+    const SavedThresholds saved;
+
+    const unsigned dc_threshold = NN::DIV_REM_DC_THRESHOLD;
+
+    const unsigned sizes[][2] = {
+        {2048, 1024}, {4000, 3999}, {8192, 1000}, {8192, 4095}, {20000, 64},
+        {30000, 9000}, {65536, 32768}, {50000, 49000}};
+
+    for (const auto& s : sizes) {
+        const NN a(s[0], rng);
+        const NN b(s[1], rng);
+
+        NN::DIV_REM_DC_THRESHOLD = 2;
+
+        NN q(a);
+        q /= b;
+
+        NN r(a);
+        r %= b;
+
+        ASSERT_LT(r, b);
+
+        NN t(q);
+        t *= b;
+        t += r;
+        ASSERT_EQ(t, a);
+
+        NN::DIV_REM_DC_THRESHOLD = 1u << 30;
+
+        NN u(a);
+        u /= b;
+
+        ASSERT_EQ(q, u);
+    }
+
+    NN::DIV_REM_DC_THRESHOLD = 2;
+
+    NN a(1u);
+    a <<= 10000;
+    a -= 1;
+
+    NN b(1u);
+    b <<= 4000;
+    b -= 1;
+
+    NN c(a);
+    c *= b;
+    c += 12345;
+    NN r(c);
+    c /= a;
+    r %= a;
+    ASSERT_EQ(c, b);
+    ASSERT_EQ(r, NN(12345));
+
+    NN::DIV_REM_DC_THRESHOLD = dc_threshold;
+
+    c = a;
+    c *= a;
+    c /= a;
+    ASSERT_EQ(c, a);
+}
+
+TEST(YMP_NNTest, addmul)
+{
+    std::mt19937 rng(42);
+
+    const unsigned sizes[][3] = {
+        {0, 64, 64}, {64, 0, 64}, {100, 64, 16}, {31, 1000, 32},
+        {5000, 100, 2000}, {10, 3000, 3000}, {20000, 8000, 9000}};
+
+    for (const auto& s : sizes) {
+        const NN a(s[0], rng);
+        const NN b(s[1], rng);
+        const NN c(s[2], rng);
+
+        NN p(b);
+        p *= c;
+
+        NN r(a);
+        r.addmul(b, c);
+        NN t(a);
+        t += p;
+        ASSERT_EQ(r, t);
+
+        r = a;
+        const bool larger = r.submul(b, c);
+        ASSERT_EQ(larger, p > a);
+        if (larger) {
+            r += a;
+            ASSERT_EQ(r, p);
+        } else {
+            r += p;
+            ASSERT_EQ(r, a);
+        }
+    }
+
+    NN a(1u);
+    a <<= 1000;
+    a -= 1;
+
+    NN r(a);
+    r.addmul(r, r);
+    NN t(a);
+    t.sqr();
+    t += a;
+    ASSERT_EQ(r, t);
+
+    r = a;
+    ASSERT_TRUE(r.submul(a, NN(2u)));
+    ASSERT_EQ(r, a);
+
+    r = a;
+    ASSERT_FALSE(r.submul(a, NN::ONE));
+    ASSERT_TRUE(r.is_zero());
+}
+
+TEST(YMP_NNTest, divexact)
+{
+    std::mt19937 rng(42);
+
+    const unsigned sizes[][2] = {
+        {64, 64}, {1000, 32}, {1000, 33}, {3000, 1000}, {5000, 4990},
+        {40000, 20000}, {100000, 300}};
+
+    for (const auto& s : sizes) {
+        const NN q(s[0], rng);
+        NN d(s[1], rng);
+
+        for (unsigned k : {0u, 1u, 32u, 77u}) {
+            NN e(d);
+            e <<= k;
+
+            NN a(q);
+            a *= e;
+            a.divexact(e);
+            ASSERT_EQ(a, q);
+        }
+    }
+
+    NN a(1u);
+    a <<= 6000;
+    NN d(1u);
+    d <<= 1234;
+    a.divexact(d);
+    ASSERT_EQ(a, NN(1u) <<= 4766);
+
+    ASSERT_THROW(a.divexact(NN::ZERO), std::domain_error);
+}
+
 TEST(YMP_NNTest, bitwise) {}
 
 TEST(YMP_NNTest, no_digits)
@@ -464,3 +915,335 @@ TEST(YMP_NNTest, gcd)
 
     ASSERT_EQ(c, NN(2));
 }
+
+TEST(YMP_NNTest, gcd_large)
+{
+    std::mt19937 rng(42);
+
+    const SavedThresholds saved;
+
+    const unsigned gcd_threshold = NN::GCD_DC_THRESHOLD;
+    const unsigned hgcd_threshold = NN::HGCD_THRESHOLD;
+
+    const unsigned sizes[][2] = {
+        {64, 64}, {65, 130}, {1000, 999}, {5000, 5000}, {8000, 300},
+        {20000, 20000}, {30000, 12345}, {40000, 40000}};
+
+    for (const auto& s : sizes) {
+        const NN c(s[1] / 3 + 1, rng);
+
+        NN a(s[0], rng);
+        NN b(s[1], rng);
+        a *= c;
+        b *= c;
+
+        NN e(a);
+        NN f(b);
+        while (!f.is_zero()) {
+            NN t(e);
+            t %= f;
+            e = f;
+            f = t;
+        }
+
+        NN::GCD_DC_THRESHOLD = 4;
+        NN::HGCD_THRESHOLD = 2;
+        ASSERT_EQ(gcd(a, b), e);
+        ASSERT_EQ(gcd(b, a), e);
+
+        NN::GCD_DC_THRESHOLD = gcd_threshold;
+        NN::HGCD_THRESHOLD = hgcd_threshold;
+        ASSERT_EQ(gcd(a, b), e);
+        ASSERT_EQ(gcd(a, NN()), a);
+    }
+}
+
+TEST(YMP_NNTest, powmod)
+{
+    std::mt19937 rng(42);
+
+    const SavedThresholds saved;
+
+    const unsigned redc_threshold = NN::POWMOD_REDC_THRESHOLD;
+
+    const unsigned sizes[][2] = {{3, 5},     {31, 64},   {32, 100},
+                                 {33, 300},  {64, 1},    {100, 700},
+                                 {1000, 64}, {1000, 500}, {3000, 200}};
+
+    for (const auto& s : sizes) {
+        for (bool odd : {true, false}) {
+            NN m(s[0], rng);
+            m += 1;
+            m.set(0);
+            if (!odd)
+                m += 1;
+
+            const NN b(s[0] + 17, rng);
+            const NN e(s[1], rng);
+
+            NN r(NN::ONE);
+            NN a(b);
+            a %= m;
+            for (unsigned long i = e.no_bits(); i-- > 0;) {
+                r.sqr();
+                r %= m;
+                if (e.test(i)) {
+                    r *= a;
+                    r %= m;
+                }
+            }
+            r %= m;
+
+            NN::POWMOD_REDC_THRESHOLD = 1;
+            ASSERT_EQ(powmod(b, e, m), r);
+
+            NN::POWMOD_REDC_THRESHOLD = 1u << 30;
+            ASSERT_EQ(powmod(b, e, m), r);
+
+            NN::POWMOD_REDC_THRESHOLD = redc_threshold;
+        }
+    }
+
+    NN p(NN::ONE);
+    p <<= 127;
+    p -= 1;
+
+    NN q(p);
+    q -= 1;
+
+    ASSERT_EQ(powmod(NN(3), p, p), NN(3));
+    ASSERT_EQ(powmod(NN(7), q, p), NN::ONE);
+    ASSERT_EQ(powmod(NN(7), NN(), p), NN::ONE);
+    ASSERT_EQ(powmod(NN(7), q, NN::ONE), NN());
+    ASSERT_EQ(powmod(p, q, p), NN());
+    ASSERT_THROW(powmod(NN(7), q, NN()), NN::DivisionByZeroError);
+}
+
+TEST(YMP_NNTest, isqrt)
+{
+    std::mt19937 rng(42);
+
+    for (unsigned b : {1, 2, 31, 32, 33, 64, 65, 127, 1000, 20000}) {
+        const NN a(b, rng);
+
+        NN r(a);
+        r.isqrt();
+
+        NN lo(r);
+        lo.sqr();
+        NN hi(r);
+        hi += 1;
+        hi.sqr();
+
+        ASSERT_LE(lo, a);
+        ASSERT_GT(hi, a);
+
+        // next to a square
+        NN s(hi);
+        s -= 1;
+        s.isqrt();
+        ASSERT_EQ(s, r);
+
+        s = hi;
+        s.isqrt();
+        r += 1;
+        ASSERT_EQ(s, r);
+    }
+
+    NN a;
+    a.isqrt();
+    ASSERT_EQ(a, NN());
+}
+
+TEST(YMP_NNTest, iroot)
+{
+    std::mt19937 rng(42);
+
+    for (unsigned b : {1, 5, 33, 64, 100, 1000, 3000, 20000}) {
+        const NN a(b, rng);
+
+        for (unsigned k : {1, 2, 3, 5, 7, 31, 100, 5000}) {
+            NN r(a);
+            r.iroot(k);
+
+            NN lo(r);
+            lo.pow(k);
+            NN hi(r);
+            hi += 1;
+            hi.pow(k);
+
+            ASSERT_LE(lo, a);
+            ASSERT_GT(hi, a);
+
+            // next to a k-th power
+            NN s(hi);
+            s -= 1;
+            s.iroot(k);
+            ASSERT_EQ(s, r);
+        }
+    }
+
+    NN a("1000000000000000000000000000000");
+    a.iroot(3);
+    ASSERT_EQ(a, NN("10000000000"));
+}
+
+TEST(YMP_NNTest, is_perfect_power)
+{
+    std::mt19937 rng(42);
+
+    NN r;
+    unsigned k;
+
+    for (unsigned b : {2, 17, 64, 300}) {
+        NN x(b, rng);
+        x += 2;
+
+        for (unsigned e : {2, 3, 6, 7, 12}) {
+            NN a(x);
+            a.pow(e);
+
+            ASSERT_TRUE(a.is_perfect_power(r, k));
+            ASSERT_EQ(k % e, 0u);
+
+            NN t(r);
+            t.pow(k);
+            ASSERT_EQ(t, a);
+
+            a *= 1000003u;
+            a *= 1000003u;
+            a *= 7u;
+            ASSERT_FALSE(a.is_perfect_power());
+        }
+    }
+
+    NN a(2u);
+    a.pow(60);
+    ASSERT_TRUE(a.is_perfect_power(r, k));
+    ASSERT_EQ(r, NN(2u));
+    ASSERT_EQ(k, 60u);
+
+    a = NN(6u);
+    a.pow(35);
+    ASSERT_TRUE(a.is_perfect_power(r, k));
+    ASSERT_EQ(r, NN(6u));
+    ASSERT_EQ(k, 35u);
+
+    ASSERT_FALSE(NN(12u).is_perfect_power(r, k));
+    ASSERT_EQ(r, NN(12u));
+    ASSERT_EQ(k, 1u);
+
+    ASSERT_FALSE(NN::ONE.is_perfect_power());
+    ASSERT_FALSE(NN().is_perfect_power());
+}
+
+TEST(YMP_NNTest, factorial)
+{
+    const SavedThresholds saved;
+
+    const unsigned swing_threshold = NN::FACTORIAL_SWING_THRESHOLD;
+
+    NN f(NN::ONE);
+    for (NN::Limb n = 0; n <= 700; ++n) {
+        if (n > 1)
+            f *= n;
+
+        NN::FACTORIAL_SWING_THRESHOLD = 2;
+        ASSERT_EQ(factorial(n), f);
+
+        NN::FACTORIAL_SWING_THRESHOLD = 1u << 30;
+        ASSERT_EQ(factorial(n), f);
+
+        NN::FACTORIAL_SWING_THRESHOLD = swing_threshold;
+    }
+
+    ASSERT_EQ(factorial(30000), partial_factorial(NN(1u), NN(30000u)));
+}
+
+TEST(YMP_NNTest, double_factorial)
+{
+    NN f[2] = {NN::ONE, NN::ONE};
+    for (NN::Limb n = 0; n <= 500; ++n) {
+        if (n > 1)
+            f[n & 1] *= n;
+
+        ASSERT_EQ(double_factorial(n), f[n & 1]);
+    }
+}
+
+TEST(YMP_NNTest, binomial)
+{
+    for (NN::Limb n = 0; n <= 60; ++n) {
+        NN b(NN::ONE);
+        for (NN::Limb k = 0; k <= n; ++k) {
+            ASSERT_EQ(binomial(NN(n), k), b);
+            b *= n - k;
+            b /= k + 1;
+        }
+        ASSERT_EQ(binomial(NN(n), n + 1), NN());
+    }
+
+    for (NN::Limb k : {1000u, 2000u, 4999u}) {
+        NN b = partial_factorial(NN(5001 - k), NN(5000u));
+        b /= factorial(k);
+
+        ASSERT_EQ(binomial(NN(5000u), k), b);
+    }
+
+    NN n(NN::ONE);
+    n <<= 100;
+
+    NN b(n);
+    b -= 1;
+    b *= n;
+    b >>= 1;
+
+    ASSERT_EQ(binomial(n, 2), b);
+}
+
+TEST(YMP_NNTest, partial_factorial)
+{
+    ASSERT_EQ(partial_factorial(NN(5u), NN(4u)), NN::ONE);
+    ASSERT_EQ(partial_factorial(NN(), NN(4u)), NN());
+    ASSERT_EQ(partial_factorial(NN(4u), NN(4u)), NN(4u));
+    ASSERT_EQ(partial_factorial(NN(4u), NN(7u)), NN(840u));
+
+    NN a(NN::ONE);
+    a <<= 80;
+
+    NN b(a);
+    b += 99;
+
+    NN p(NN::ONE);
+    for (NN t(a); t <= b; t += 1)
+        p *= t;
+
+    ASSERT_EQ(partial_factorial(a, b), p);
+}
+
+TEST(YMP_NNTest, thresholds)
+{
+    const SavedThresholds restore;
+
+    const unsigned toom22_threshold = NN::MUL_TOOM22_THRESHOLD;
+
+    std::stringstream saved;
+    NN::save_thresholds(saved);
+
+    std::istringstream tuned("# tuned\n\nMUL_TOOM22_THRESHOLD = 40 # here\n");
+    NN::load_thresholds(tuned);
+    ASSERT_EQ(NN::MUL_TOOM22_THRESHOLD, 40u);
+
+    for (const char* s : {"FOO = 3",
+                          "MUL_TOOM22_THRESHOLD 3",
+                          "MUL_TOOM22_THRESHOLD = 3 4",
+                          "MUL_TOOM22_THRESHOLD = 1",
+                          "MUL_TOOM22_THRESHOLD = 50\nLIMB_BITS = 16"}) {
+        std::istringstream is(s);
+        ASSERT_THROW(NN::load_thresholds(is), std::invalid_argument);
+        ASSERT_EQ(NN::MUL_TOOM22_THRESHOLD, 40u);
+    }
+
+    NN::load_thresholds(saved);
+    ASSERT_EQ(NN::MUL_TOOM22_THRESHOLD, toom22_threshold);
+}
@@ -0,0 +1,96 @@
+/*
+ *
+ * This file is part of yacas.
+ * Yacas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesset General Public License as
+ * published by the Free Software Foundation, either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * Yacas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with yacas.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "yacas/mp/small_vector.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace yacas::mp;
+
+typedef SmallVector<unsigned, 2> V;
+
+TEST(YMP_SmallVectorTest, inline_storage)
+{
+    V v;
+    ASSERT_TRUE(v.empty());
+    ASSERT_EQ(v.capacity(), 2);
+
+    v.push_back(1);
+    v.push_back(2);
+    ASSERT_EQ(v.capacity(), 2);
+
+    v.push_back(3);
+    ASSERT_GT(v.capacity(), 2);
+    ASSERT_EQ(v, V({1, 2, 3}));
+}
+
+TEST(YMP_SmallVectorTest, copy_move_swap)
+{
+    const V small{7};
+    const V large{1, 2, 3, 4, 5};
+
+    for (const V* p : {&small, &large}) {
+        for (const V* q : {&small, &large}) {
+            V a(*p);
+            V b(*q);
+
+            a.swap(b);
+            ASSERT_EQ(a, *q);
+            ASSERT_EQ(b, *p);
+
+            V c(std::move(a));
+            ASSERT_EQ(c, *q);
+
+            b = std::move(c);
+            ASSERT_EQ(b, *q);
+
+            c = *p;
+            ASSERT_EQ(c, *p);
+        }
+    }
+}
+
+TEST(YMP_SmallVectorTest, insert_erase)
+{
+    std::vector<unsigned> r;
+    V v;
+
+    for (unsigned i = 0; i < 20; ++i) {
+        v.insert(v.begin() + v.size() / 2, i % 3, i);
+        r.insert(r.begin() + r.size() / 2, i % 3, i);
+    }
+    ASSERT_TRUE(std::equal(v.begin(), v.end(), r.begin(), r.end()));
+
+    const V w{100, 101, 102};
+    v.insert(v.begin() + 1, w.begin(), w.end());
+    r.insert(r.begin() + 1, w.begin(), w.end());
+    ASSERT_TRUE(std::equal(v.begin(), v.end(), r.begin(), r.end()));
+
+    v.erase(v.begin() + 2, v.begin() + 9);
+    r.erase(r.begin() + 2, r.begin() + 9);
+    ASSERT_TRUE(std::equal(v.begin(), v.end(), r.begin(), r.end()));
+
+    v.resize(40, 9);
+    r.resize(40, 9);
+    ASSERT_TRUE(std::equal(v.rbegin(), v.rend(), r.rbegin(), r.rend()));
+
+    v.assign(1, 5);
+    ASSERT_EQ(v, V({5}));
+}
@@ -0,0 +1,98 @@
+/*
+ *
+ * This file is part of yacas.
+ * Yacas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesset General Public License as
+ * published by the Free Software Foundation, either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * Yacas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with yacas.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "yacas/mp/thread_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+using namespace yacas::mp;
+
+namespace {
+    unsigned long fib(ThreadPool& pool, unsigned n)
+    {
+        if (n < 2)
+            return n;
+
+        unsigned long a = 0, b = 0;
+        pool.invoke([&] { a = fib(pool, n - 1); }, [&] { b = fib(pool, n - 2); });
+        return a + b;
+    }
+}
+
+TEST(YMP_ThreadPoolTest, size)
+{
+    ASSERT_EQ(ThreadPool(1).size(), 1u);
+    ASSERT_EQ(ThreadPool(4).size(), 4u);
+}
+
+TEST(YMP_ThreadPoolTest, invoke)
+{
+    for (unsigned n : {1u, 2u, 4u}) {
+        ThreadPool pool(n);
+
+        int a = 0, b = 0, c = 0;
+        pool.invoke([&] { a = 1; }, [&] { b = 2; }, [&] { c = 3; });
+        ASSERT_EQ(a + b + c, 6);
+
+        pool.invoke([&] { a = 4; });
+        ASSERT_EQ(a, 4);
+    }
+}
+
+TEST(YMP_ThreadPoolTest, nested)
+{
+    for (unsigned n : {1u, 3u, 8u})  {
+        ThreadPool pool(n);
+        ASSERT_EQ(fib(pool, 20), 6765u);
+    }
+}
+
+TEST(YMP_ThreadPoolTest, for_range)
+{
+    ThreadPool pool(4);
+
+    std::vector<unsigned> v(100000, 0);
+    pool.for_range(0, v.size(), 1000, [&](std::size_t b, std::size_t e) {
+        ASSERT_LE(e - b, 1000u);
+        for (std::size_t i = b; i < e; ++i)
+            v[i] += i;
+    });
+
+    for (std::size_t i = 0; i < v.size(); ++i)
+        ASSERT_EQ(v[i], i);
+
+    pool.for_range(5, 5, 1, [](std::size_t, std::size_t) { FAIL(); });
+}
+
+TEST(YMP_ThreadPoolTest, exception)
+{
+    ThreadPool pool(2);
+
+    int done = 0;
+    ASSERT_THROW(pool.invoke([&] { done += 1; },
+                             [] { throw std::runtime_error("task"); },
+                             [&] { done += 1; }),
+                 std::runtime_error);
+
+    // the others have run to completion
+    ASSERT_EQ(done, 2);
+}
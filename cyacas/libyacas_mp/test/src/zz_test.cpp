@@ -281,6 +281,67 @@ TEST(YMP_ZZTest, div)
     ASSERT_EQ(a, ZZ("-100000000000000000000000000000000000000000000000000000000000000000000000000000000"));
 }
 
+TEST(YMP_ZZTest, addmul)
+{
+    const ZZ a("123456789012345678901234567890");
+    const ZZ b("-98765432109876543210");
+    const ZZ c("55555555555555555555555");
+
+    const auto neg = [](ZZ z) {
+        z.neg();
+        return z;
+    };
+
+    for (const ZZ& x : {a, neg(a), ZZ::ZERO})
+        for (const ZZ& y : {b, neg(b)})
+            for (const ZZ& z : {c, neg(c), ZZ(7), ZZ(-7)}) {
+                ZZ p(y);
+                p *= z;
+
+                ZZ r(x);
+                r.addmul(y, z);
+                ZZ t(x);
+                t += p;
+                ASSERT_EQ(r, t);
+
+                r = x;
+                r.submul(y, z);
+                t = x;
+                t -= p;
+                ASSERT_EQ(r, t);
+            }
+
+    ZZ r(-7);
+    r.addmul(ZZ(7), ZZ::ONE);
+    ASSERT_TRUE(r.is_zero());
+    ASSERT_FALSE(r.is_negative());
+}
+
+TEST(YMP_ZZTest, divexact)
+{
+    const ZZ a("-123456789012345678901234567890");
+    const ZZ b("98765432109876543210");
+
+    const auto neg = [](ZZ z) {
+        z.neg();
+        return z;
+    };
+
+    for (const ZZ& x : {a, neg(a)})
+        for (const ZZ& y : {b, neg(b)}) {
+            ZZ p(x);
+            p *= y;
+            p.divexact(y);
+            ASSERT_EQ(p, x);
+        }
+
+    ZZ z;
+    z.divexact(b);
+    ASSERT_TRUE(z.is_zero());
+
+    ASSERT_THROW(z.divexact(ZZ::ZERO), std::domain_error);
+}
+
 TEST(YMP_ZZTest, rem)
 {
     ZZ a(3);
@@ -332,3 +393,82 @@ TEST(YMP_ZZTest, gcd)
 
     ASSERT_EQ(c, ZZ(2));
 }
+
+TEST(YMP_ZZTest, xgcd)
+{
+    ZZ s;
+    ZZ t;
+
+    ASSERT_EQ(xgcd(ZZ(240), ZZ(46), s, t), ZZ(2));
+    ASSERT_EQ(s, ZZ(-9));
+    ASSERT_EQ(t, ZZ(47));
+
+    ASSERT_EQ(xgcd(ZZ(-240), ZZ(46), s, t), ZZ(2));
+    ASSERT_EQ(s, ZZ(9));
+    ASSERT_EQ(t, ZZ(47));
+
+    ASSERT_EQ(xgcd(ZZ(6), ZZ(3), s, t), ZZ(3));
+    ASSERT_EQ(s, ZZ(0));
+    ASSERT_EQ(t, ZZ(1));
+
+    ASSERT_EQ(xgcd(ZZ(0), ZZ(7), s, t), ZZ(7));
+    ASSERT_EQ(s, ZZ(0));
+    ASSERT_EQ(t, ZZ(1));
+
+    std::mt19937 rng(42);
+
+    const unsigned gcd_threshold = NN::GCD_DC_THRESHOLD;
+    const unsigned hgcd_threshold = NN::HGCD_THRESHOLD;
+    NN::GCD_DC_THRESHOLD = 4;
+    NN::HGCD_THRESHOLD = 2;
+
+    for (unsigned bits : {100u, 3000u, 20000u}) {
+        ZZ a(bits, rng);
+        ZZ b(bits - 7, rng);
+        a.neg();
+
+        const ZZ g = xgcd(a, b, s, t);
+
+        ASSERT_EQ(g, gcd(a, b));
+
+        ZZ u(s);
+        u *= a;
+        ZZ v(t);
+        v *= b;
+        u += v;
+        ASSERT_EQ(u, g);
+
+        // |s| <= |b| / (2 g)
+        ZZ w(s);
+        w.abs();
+        w *= g;
+        w <<= 1;
+        ZZ x(b);
+        x.abs();
+        ASSERT_LE(w, x);
+    }
+
+    NN::GCD_DC_THRESHOLD = gcd_threshold;
+    NN::HGCD_THRESHOLD = hgcd_threshold;
+}
+
+TEST(YMP_ZZTest, powmod)
+{
+    ASSERT_EQ(powmod(ZZ(-3), ZZ(5), ZZ(7)), ZZ(2));
+    ASSERT_EQ(powmod(ZZ(3), ZZ(5), ZZ(7)), ZZ(5));
+    ASSERT_EQ(powmod(ZZ(-14), ZZ(3), ZZ(7)), ZZ(0));
+    ASSERT_EQ(powmod(ZZ(-1), ZZ(0), ZZ(7)), ZZ(1));
+    ASSERT_THROW(powmod(ZZ(3), ZZ(5), ZZ(0)), ZZ::DivisionByZeroError);
+    ASSERT_THROW(powmod(ZZ(3), ZZ(-5), ZZ(7)), std::domain_error);
+    ASSERT_THROW(powmod(ZZ(3), ZZ(5), ZZ(-7)), std::domain_error);
+}
+
+TEST(YMP_ZZTest, partial_factorial)
+{
+    ASSERT_EQ(partial_factorial(ZZ(3), ZZ(5)), ZZ(60));
+    ASSERT_EQ(partial_factorial(ZZ(5), ZZ(3)), ZZ(1));
+    ASSERT_EQ(partial_factorial(ZZ(-2), ZZ(3)), ZZ(0));
+    ASSERT_EQ(partial_factorial(ZZ(-5), ZZ(-2)), ZZ(120));
+    ASSERT_EQ(partial_factorial(ZZ(-5), ZZ(-3)), ZZ(-60));
+    ASSERT_EQ(partial_factorial(ZZ(-1), ZZ(-1)), ZZ(-1));
+}
@@ -0,0 +1,341 @@
+/*
+ *
+ * This file is part of yacas.
+ * Yacas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesset General Public License as
+ * published by the Free Software Foundation, either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * Yacas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with yacas.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Measures the crossover points between the algorithms in libyacas_mp on
+// the host and writes them in the format read by NN::load_thresholds().
+//
+// A crossover is found by timing an operation of size n twice, once with
+// the threshold set to n + 1, so that the simpler algorithm is used at the
+// top level, and once with the threshold set to n. The smallest n from
+// which on the latter wins a few times in a row becomes the threshold.
+// Thresholds are tuned in order, each with the previous ones already set.
+
+#include "yacas/mp/zz.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <thread>
+
+using namespace yacas::mp;
+
+namespace {
+    std::mt19937 rng(42);
+
+    bool verbose = true;
+
+    // a random number of exactly n limbs
+    NN random_nn(unsigned n)
+    {
+        std::uniform_int_distribution<NN::Limb> d;
+
+        std::vector<NN::Limb> v(n);
+        for (NN::Limb& l : v)
+            l = d(rng);
+        v.back() |= NN::Limb(1) << (sizeof(NN::Limb) * CHAR_BIT - 1);
+
+        return NN(v);
+    }
+
+    // seconds per call of f, best of a few runs of at least 2 ms each
+    double measure(const std::function<void()>& f)
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        double best = std::numeric_limits<double>::max();
+
+        for (int i = 0; i < 5; ++i) {
+            const Clock::time_point start = Clock::now();
+
+            unsigned calls = 0;
+            double t;
+            do {
+                f();
+                calls += 1;
+                t = std::chrono::duration<double>(Clock::now() - start).count();
+            } while (t < 2e-3);
+
+            best = std::min(best, t / calls);
+        }
+
+        return best;
+    }
+
+    typedef std::function<std::function<void()>(unsigned)> Operation;
+
+    // smallest n in [lo, hi] from which on threshold = n beats
+    // threshold = n + 1 for three sizes in a row; hi if there is none
+    void crossover(const char* name,
+                   unsigned& threshold,
+                   unsigned lo,
+                   unsigned hi,
+                   const Operation& op)
+    {
+        const unsigned old = threshold;
+
+        unsigned first = hi;
+        unsigned wins = 0;
+
+        for (unsigned n = lo; n <= hi && wins < 3;
+             n += std::max(1u, n / 16)) {
+            const std::function<void()> f = op(n);
+
+            threshold = n + 1;
+            const double slow = measure(f);
+
+            threshold = n;
+            const double fast = measure(f);
+
+            if (verbose)
+                std::cerr << name << ' ' << n << ": " << slow * 1e6 << " us vs "
+                          << fast * 1e6 << " us\n";
+
+            if (fast < slow) {
+                if (wins++ == 0)
+                    first = n;
+            } else {
+                wins = 0;
+                first = hi;
+            }
+        }
+
+        threshold = first;
+
+        std::cerr << name << " = " << threshold << " (was " << old << ")\n";
+    }
+
+    // the candidate from [lo, hi] for which op runs fastest
+    void minimum(const char* name,
+                 unsigned& threshold,
+                 unsigned lo,
+                 unsigned hi,
+                 const std::function<void()>& op)
+    {
+        const unsigned old = threshold;
+
+        unsigned best = old;
+        double best_time = std::numeric_limits<double>::max();
+
+        for (unsigned n = lo; n <= hi; n += std::max(1u, n / 8)) {
+            threshold = n;
+            const double t = measure(op);
+
+            if (verbose)
+                std::cerr << name << ' ' << n << ": " << t * 1e6 << " us\n";
+
+            if (t < best_time) {
+                best = n;
+                best_time = t;
+            }
+        }
+
+        threshold = best;
+
+        std::cerr << name << " = " << threshold << " (was " << old << ")\n";
+    }
+
+    void tune_mul()
+    {
+        const Operation mul = [](unsigned n) {
+            const NN a = random_nn(n);
+            const NN b = random_nn(n);
+            return [a, b]() {
+                NN c(a);
+                c *= b;
+            };
+        };
+
+        crossover("MUL_TOOM22_THRESHOLD", NN::MUL_TOOM22_THRESHOLD, 4, 200,
+                  mul);
+        crossover("MUL_TOOM33_THRESHOLD",
+                  NN::MUL_TOOM33_THRESHOLD,
+                  NN::MUL_TOOM22_THRESHOLD,
+                  400,
+                  mul);
+        crossover("MUL_FFT_THRESHOLD",
+                  NN::MUL_FFT_THRESHOLD,
+                  NN::MUL_TOOM33_THRESHOLD,
+                  16384,
+                  mul);
+
+        // on the threads of YACAS_MP_THREADS, or else on all the host has
+        const unsigned threads = NN::threads();
+        const unsigned n =
+            threads > 1 ? threads : std::thread::hardware_concurrency();
+
+        if (n < 2) {
+            std::cerr << "MUL_THREADS_THRESHOLD = " << NN::MUL_THREADS_THRESHOLD
+                      << " (not tuned, no threads to spread over)\n";
+            return;
+        }
+
+        NN::set_threads(n);
+        crossover("MUL_THREADS_THRESHOLD",
+                  NN::MUL_THREADS_THRESHOLD,
+                  NN::MUL_TOOM22_THRESHOLD,
+                  1 << 16,
+                  mul);
+        NN::set_threads(threads);
+    }
+
+    void tune_div_rem()
+    {
+        crossover("DIV_REM_DC_THRESHOLD",
+                  NN::DIV_REM_DC_THRESHOLD,
+                  4,
+                  1024,
+                  [](unsigned n) {
+                      const NN a = random_nn(2 * n);
+                      const NN b = random_nn(n);
+                      return [a, b]() {
+                          NN q(a);
+                          q /= b;
+                      };
+                  });
+    }
+
+    void tune_to_string()
+    {
+        crossover("TO_STRING_DC_THRESHOLD",
+                  NN::TO_STRING_DC_THRESHOLD,
+                  3,
+                  1024,
+                  [](unsigned n) {
+                      const NN a = random_nn(n);
+                      return [a]() { a.to_string(); };
+                  });
+    }
+
+    void tune_parse()
+    {
+        crossover("PARSE_DC_THRESHOLD",
+                  NN::PARSE_DC_THRESHOLD,
+                  4,
+                  4096,
+                  [](unsigned n) {
+                      // just over the number of digits in n limbs
+                      std::uniform_int_distribution<int> d('0', '9');
+                      std::string s(n * sizeof(NN::Limb) * CHAR_BIT * 0.30103 + 1, '0');
+                      for (char& c : s)
+                          c = d(rng);
+                      s[0] = '1';
+                      return [s]() { NN a(s); };
+                  });
+    }
+
+    void tune_gcd()
+    {
+        const unsigned gcd_threshold = NN::GCD_DC_THRESHOLD;
+
+        // the half gcd recursion pays off only on large numbers, so its
+        // leaf size is chosen by timing the gcd of numbers well above it
+        NN::GCD_DC_THRESHOLD = 4;
+
+        const NN a = random_nn(4000);
+        const NN b = random_nn(4000);
+        minimum("HGCD_THRESHOLD", NN::HGCD_THRESHOLD, 32, 1024, [&a, &b]() {
+            gcd(a, b);
+        });
+
+        NN::GCD_DC_THRESHOLD = gcd_threshold;
+
+        crossover("GCD_DC_THRESHOLD",
+                  NN::GCD_DC_THRESHOLD,
+                  NN::HGCD_THRESHOLD,
+                  8192,
+                  [](unsigned n) {
+                      const NN a = random_nn(n);
+                      const NN b = random_nn(n);
+                      return [a, b]() { gcd(a, b); };
+                  });
+    }
+
+    void tune_powmod()
+    {
+        crossover("POWMOD_REDC_THRESHOLD",
+                  NN::POWMOD_REDC_THRESHOLD,
+                  8,
+                  2048,
+                  [](unsigned n) {
+                      const NN b = random_nn(n);
+                      const NN e = random_nn(2);
+                      NN m = random_nn(n);
+                      m.set(0);
+                      return [b, e, m]() { powmod(b, e, m); };
+                  });
+    }
+
+    void tune_factorial()
+    {
+        crossover("FACTORIAL_SWING_THRESHOLD",
+                  NN::FACTORIAL_SWING_THRESHOLD,
+                  64,
+                  1 << 16,
+                  [](unsigned n) { return [n]() { factorial(n); }; });
+    }
+
+    void usage(const char* name)
+    {
+        std::cerr << "usage: " << name << " [-q] [-o file]\n"
+                  << "  -q       report only the tuned thresholds\n"
+                  << "  -o file  write the thresholds to file instead of "
+                     "standard output\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const char* output = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-q") == 0) {
+            verbose = false;
+        } else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    tune_mul();
+    tune_div_rem();
+    tune_to_string();
+    tune_parse();
+    tune_gcd();
+    tune_powmod();
+    tune_factorial();
+
+    std::ofstream f;
+    if (output) {
+        f.open(output);
+        if (!f) {
+            std::cerr << argv[0] << ": cannot open " << output << '\n';
+            return 1;
+        }
+    }
+
+    std::ostream& os = output ? f : std::cout;
+
+    os << "# yacas_mp thresholds measured by mp_tune\n";
+    NN::save_thresholds(os);
+
+    return 0;
+}
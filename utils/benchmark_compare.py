@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+#
+# This file is part of yacas.
+# Yacas is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesset General Public License as
+# published by the Free Software Foundation, either version 2.1
+# of the License, or (at your option) any later version.
+#
+# Yacas is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with yacas.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""Compare Google Benchmark results with a stored baseline.
+
+Each RESULT is a JSON file written by a benchmark with --benchmark_out; it
+is compared with the file of the same name in BASELINE_DIR, or with
+BASELINE_DIR itself if that is a file. A case is a regression if its CPU
+time per iteration grew by more than the threshold. Changes of the fitted
+complexity are reported too. The exit status is 1 if there were any
+regressions and 2 if a baseline is missing.
+"""
+
+import argparse
+import json
+import os
+import sys
+
+UNITS = {'ns': 1e-9, 'us': 1e-6, 'ms': 1e-3, 's': 1.0}
+
+
+def load(path):
+    """Returns the iteration times in seconds and the fitted complexities,
+    both keyed by case name."""
+    with open(path) as f:
+        benchmarks = json.load(f)['benchmarks']
+
+    times = {}
+    complexities = {}
+    seen = {}
+
+    for b in benchmarks:
+        name = b['name']
+
+        # a family registered more than once repeats its names; the
+        # repetitions of one run do too, but those are told apart by
+        # their index, and all count as the same case
+        run = (name, b.get('repetition_index'), b.get('aggregate_name'))
+        n = seen.get(run, 0)
+        seen[run] = n + 1
+        if n:
+            name += ' #%d' % (n + 1)
+
+        if b.get('run_type') == 'aggregate':
+            if b.get('aggregate_name') == 'BigO':
+                complexities[name] = b['big_o']
+            continue
+
+        if b.get('error_occurred'):
+            continue
+
+        # with repetitions the fastest run is the least disturbed one
+        t = b['cpu_time'] * UNITS[b.get('time_unit', 'ns')]
+        times[name] = min(t, times.get(name, t))
+
+    return times, complexities
+
+
+def format_time(t):
+    for unit in ('s', 'ms', 'us', 'ns'):
+        if t >= UNITS[unit] or unit == 'ns':
+            return '%.3g %s' % (t / UNITS[unit], unit)
+
+
+def compare(baseline_path, result_path, threshold, verbose):
+    """Prints the comparison of one result file, returns the number of
+    regressions."""
+    base_times, base_complexities = load(baseline_path)
+    times, complexities = load(result_path)
+
+    print('%s vs %s' % (result_path, baseline_path))
+
+    regressions = 0
+    improvements = 0
+
+    for name, t in times.items():
+        if name not in base_times:
+            if verbose:
+                print('  %-50s %12s  new' % (name, format_time(t)))
+            continue
+
+        b = base_times[name]
+        change = (t - b) / b * 100 if b > 0 else 0.0
+
+        if change > threshold:
+            regressions += 1
+            tag = 'REGRESSION'
+        elif change < -threshold:
+            improvements += 1
+            tag = 'improvement'
+        else:
+            tag = ''
+
+        if tag or verbose:
+            print('  %-50s %12s -> %12s  %+7.1f%%  %s'
+                  % (name, format_time(b), format_time(t), change, tag))
+
+    for name in base_times:
+        if name not in times:
+            print('  %-50s missing' % name)
+
+    for name, c in complexities.items():
+        b = base_complexities.get(name)
+        if b is not None and b != c:
+            print('  %-50s complexity %s -> %s' % (name, b, c))
+
+    print('  %d regressions, %d improvements, %d cases'
+          % (regressions, improvements, len(times)))
+
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('-t', '--threshold', type=float, default=10.0,
+                        help='slowdown in percent reported as a regression '
+                             '(default: %(default)s)')
+    parser.add_argument('-v', '--verbose', action='store_true',
+                        help='list all the cases, not only the changed ones')
+    parser.add_argument('baseline', metavar='BASELINE_DIR')
+    parser.add_argument('results', metavar='RESULT', nargs='+')
+    args = parser.parse_args()
+
+    regressions = 0
+    missing = 0
+
+    for r in args.results:
+        b = args.baseline
+        if os.path.isdir(b):
+            b = os.path.join(b, os.path.basename(r))
+
+        if not os.path.exists(b):
+            print('%s: no baseline %s, run bench_baseline first' % (r, b))
+            missing += 1
+            continue
+
+        regressions += compare(b, r, args.threshold, args.verbose)
+
+    if regressions:
+        return 1
+
+    return 2 if missing else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())